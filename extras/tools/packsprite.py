@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""Convert sprites to the packed format drawn by Sprites::drawPacked...().
+
+The input can be an image file (requires the Pillow package) or a C/C++
+source file containing an ordinary Sprites array. The packed array is
+written to standard output as C++ source.
+
+Image input:
+  Pixels lighter than 50% grey are white (1), others are black (0).
+  If --mask is given, pixels that are more than 50% transparent are masked
+  out (mask bit 0) and all others are part of the mask (mask bit 1).
+  The image is divided into frames of --width by --height pixels, taken
+  left to right then top to bottom. By default the whole image is one frame.
+
+Array input (--array):
+  The first array of numbers in the file is used. It must start with the
+  width and height, followed by the frame data as used by the Sprites class.
+  If --mask is given the frame data is taken to be image and mask byte pairs,
+  as used by drawPlusMask().
+
+Examples:
+  packsprite.py player.png --width 16 --height 16 --mask --name player
+  packsprite.py --array sprites.h --name logo
+"""
+
+import argparse
+import re
+import sys
+
+MAX_LITERAL = 128
+MAX_RUN = 65
+MIN_COPY = 3
+MAX_COPY = 66
+MAX_DISTANCE = 0xFFFF
+
+
+def frames_from_image(path, frame_w, frame_h, with_mask):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("The Pillow package is required to read images")
+
+    img = Image.open(path).convert("RGBA")
+    frame_w = frame_w or img.width
+    frame_h = frame_h or img.height
+    if img.width % frame_w or img.height % frame_h:
+        sys.exit("The image size must be a multiple of the frame size")
+
+    pages = (frame_h + 7) // 8
+    frames = []
+    for fy in range(0, img.height, frame_h):
+        for fx in range(0, img.width, frame_w):
+            image = []
+            mask = []
+            for page in range(pages):
+                for x in range(frame_w):
+                    ib = mb = 0
+                    for bit in range(8):
+                        y = page * 8 + bit
+                        if y >= frame_h:
+                            break
+                        r, g, b, a = img.getpixel((fx + x, fy + y))
+                        if (r * 299 + g * 587 + b * 114) // 1000 > 127:
+                            ib |= 1 << bit
+                        if a >= 128:
+                            mb |= 1 << bit
+                    image.append(ib)
+                    mask.append(mb)
+            frames.append((image, mask if with_mask else None))
+    return frame_w, frame_h, frames
+
+
+def frames_from_array(path, with_mask):
+    text = open(path).read()
+    text = re.sub(r"//.*", "", text)
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    m = re.search(r"\{([^{}]*)\}", text)
+    if not m:
+        sys.exit("No array found in " + path)
+    values = [int(v, 0) & 0xFF for v in re.findall(r"0[xX][0-9a-fA-F]+|\d+", m.group(1))]
+    width, height = values[0], values[1]
+    data = values[2:]
+    size = width * ((height + 7) // 8) * (2 if with_mask else 1)
+    if size == 0 or len(data) % size:
+        sys.exit("The array size doesn't match its width and height")
+
+    frames = []
+    for i in range(0, len(data), size):
+        frame = data[i:i + size]
+        if with_mask:
+            frames.append((frame[0::2], frame[1::2]))
+        else:
+            frames.append((frame, None))
+    return width, height, frames
+
+
+def find_copy(out, start, data, pos):
+    """Find the longest earlier copy of data[pos:] in out[start:]."""
+    best_len = 0
+    best_src = 0
+    limit = min(MAX_COPY, len(data) - pos)
+    if limit < MIN_COPY:
+        return 0, 0
+    code_addr = len(out)
+    lo = max(start, code_addr - MAX_DISTANCE)
+    first = data[pos]
+    for src in range(lo, code_addr):
+        if out[src] != first:
+            continue
+        n = 1
+        while n < limit and src + n < code_addr and out[src + n] == data[pos + n]:
+            n += 1
+        if n > best_len:
+            best_len = n
+            best_src = src
+            if n == limit:
+                break
+    return best_len, best_src
+
+
+def encode_stream(out, start, data):
+    """Append the codes for data to out. Copies only come from out[start:]."""
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            del literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    pos = 0
+    while pos < len(data):
+        run = 1
+        while run < MAX_RUN and pos + run < len(data) and data[pos + run] == data[pos]:
+            run += 1
+
+        # the pending literal bytes are written before a copy's code, so they
+        # can be copied from too
+        copy_len, copy_src = find_copy(out + literal_preview(literal), start, data, pos)
+
+        if copy_len >= 4 and copy_len > run:
+            flush()
+            code_addr = len(out)
+            out.append(0xC0 | (copy_len - MIN_COPY))
+            distance = code_addr - copy_src
+            out.extend((distance & 0xFF, distance >> 8))
+            pos += copy_len
+        elif run >= 3 or (run == 2 and not literal):
+            flush()
+            out.extend((0x80 | (run - 2), data[pos]))
+            pos += run
+        else:
+            literal.append(data[pos])
+            pos += 1
+    flush()
+
+
+def literal_preview(literal):
+    """The bytes that flushing the pending literal bytes will produce."""
+    preview = []
+    for i in range(0, len(literal), MAX_LITERAL):
+        chunk = literal[i:i + MAX_LITERAL]
+        preview.append(len(chunk) - 1)
+        preview.extend(chunk)
+    return preview
+
+
+def decode_stream(packed, pos, size):
+    """Decode a stream, for checking the result."""
+    result = []
+    while len(result) < size:
+        c = packed[pos]
+        if c < 0x80:
+            result.extend(packed[pos + 1:pos + 2 + c])
+            pos += c + 2
+        elif c < 0xC0:
+            result.extend([packed[pos + 1]] * ((c & 0x3F) + 2))
+            pos += 2
+        else:
+            src = pos - (packed[pos + 1] | (packed[pos + 2] << 8))
+            result.extend(packed[src:src + (c & 0x3F) + MIN_COPY])
+            pos += 3
+    return result[:size] if len(result) == size else None
+
+
+def pack(width, height, frames):
+    with_mask = frames[0][1] is not None
+    streams = []
+    for image, mask in frames:
+        streams.append(image)
+        if with_mask:
+            streams.append(mask)
+
+    out = [width, height, len(frames), 1 if with_mask else 0]
+    table = len(out)
+    out.extend([0, 0] * len(streams))
+    start = len(out)
+
+    for i, stream in enumerate(streams):
+        offset = len(out)
+        if offset > 0xFFFF:
+            sys.exit("The packed array is too large")
+        out[table + i * 2] = offset & 0xFF
+        out[table + i * 2 + 1] = offset >> 8
+        encode_stream(out, start, stream)
+
+    for i, stream in enumerate(streams):
+        offset = out[table + i * 2] | (out[table + i * 2 + 1] << 8)
+        if decode_stream(out, offset, len(stream)) != stream:
+            sys.exit("Internal error: the packed data doesn't decode correctly")
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="image file, or source file with --array")
+    parser.add_argument("--array", action="store_true",
+                        help="read an ordinary Sprites array from a source file")
+    parser.add_argument("--mask", action="store_true",
+                        help="include a mask with each frame, for drawPackedPlusMask()")
+    parser.add_argument("--width", type=int, default=0, help="frame width for image input")
+    parser.add_argument("--height", type=int, default=0, help="frame height for image input")
+    parser.add_argument("--name", default="sprite", help="name of the array")
+    args = parser.parse_args()
+
+    if args.array:
+        width, height, frames = frames_from_array(args.input, args.mask)
+    else:
+        width, height, frames = frames_from_image(args.input, args.width, args.height, args.mask)
+
+    if not 0 < width < 256 or not 0 < height < 256 or len(frames) > 255:
+        sys.exit("The width, height and number of frames must be from 1 to 255")
+
+    packed = pack(width, height, frames)
+    unpacked = 2 + sum(len(image) + len(mask or []) for image, mask in frames)
+
+    print("// %dx%d, %d frame%s%s: %d bytes packed, %d bytes unpacked" %
+          (width, height, len(frames), "" if len(frames) == 1 else "s",
+           " with masks" if frames[0][1] is not None else "", len(packed), unpacked))
+    print("const uint8_t PROGMEM %s[] = {" % args.name)
+    for i in range(0, len(packed), 12):
+        print("  " + ", ".join("0x%02X" % b for b in packed[i:i + 12]) + ",")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
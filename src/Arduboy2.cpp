@@ -13,6 +13,23 @@
 //========================================
 
 uint8_t Arduboy2Base::sBuffer[];
+uint8_t Arduboy2Base::asyncBuffer[];
+
+uint8_t Arduboy2Base::dirtyStartX = 0xFF;
+uint8_t Arduboy2Base::dirtyEndX = 0;
+uint8_t Arduboy2Base::dirtyStartPage = 0xFF;
+uint8_t Arduboy2Base::dirtyEndPage = 0;
+
+uint8_t Arduboy2Base::scrollLine = 0;
+
+#ifdef CLIP_RECT_MODE
+uint8_t Arduboy2Base::clipLeft = 0;
+uint8_t Arduboy2Base::clipTop = 0;
+uint8_t Arduboy2Base::clipRight = WIDTH;
+uint8_t Arduboy2Base::clipBottom = HEIGHT;
+uint8_t Arduboy2Base::clipStack[CLIP_STACK_DEPTH][4];
+uint8_t Arduboy2Base::clipDepth = 0;
+#endif
 
 Arduboy2Base::Arduboy2Base()
 {
@@ -306,13 +323,17 @@ void Arduboy2Base::clear()
 
 void Arduboy2Base::drawPixel(int16_t x, int16_t y, uint8_t color)
 {
-  #ifdef PIXEL_SAFE_MODE
-  if (x < 0 || x > (WIDTH-1) || y < 0 || y > (HEIGHT-1))
+  #if defined(PIXEL_SAFE_MODE) || defined(CLIP_RECT_MODE)
+  if (x < CLIP_LEFT || x > (CLIP_RIGHT-1) || y < CLIP_TOP || y > (CLIP_BOTTOM-1))
   {
     return;
   }
   #endif
 
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, 1, 1);
+  #endif
+
   uint16_t row_offset;
   uint8_t bit;
 
@@ -350,13 +371,17 @@ void Arduboy2Base::drawPixel(int16_t x, int16_t y, uint8_t color)
 // For reference, this is the C++ equivalent
 void Arduboy2Base::drawPixel(int16_t x, int16_t y, uint8_t color)
 {
-  #ifdef PIXEL_SAFE_MODE
-  if (x < 0 || x > (WIDTH-1) || y < 0 || y > (HEIGHT-1))
+  #if defined(PIXEL_SAFE_MODE) || defined(CLIP_RECT_MODE)
+  if (x < CLIP_LEFT || x > (CLIP_RIGHT-1) || y < CLIP_TOP || y > (CLIP_BOTTOM-1))
   {
     return;
   }
   #endif
 
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, 1, 1);
+  #endif
+
   uint16_t row_offset;
   uint8_t bit;
 
@@ -457,15 +482,28 @@ void Arduboy2Base::drawCircleHelper
   }
 }
 
+// The byte of a fill pattern for column x, or all pixels for a solid fill
+static uint8_t patternColumn(const uint8_t *pattern, int16_t x)
+{
+  return (pattern == NULL) ? 0xFF : pgm_read_byte(pattern + (x & 7));
+}
+
 void Arduboy2Base::fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
 {
   drawFastVLine(x0, y0-r, 2*r+1, color);
   fillCircleHelper(x0, y0, r, 3, 0, color);
 }
 
+void Arduboy2Base::fillCirclePattern
+(int16_t x0, int16_t y0, uint8_t r, const uint8_t *pattern, uint8_t color)
+{
+  fillColumn(x0, y0-r, 2*r+1, color, patternColumn(pattern, x0));
+  fillCircleHelper(x0, y0, r, 3, 0, color, pattern);
+}
+
 void Arduboy2Base::fillCircleHelper
 (int16_t x0, int16_t y0, uint8_t r, uint8_t sides, int16_t delta,
- uint8_t color)
+ uint8_t color, const uint8_t *pattern)
 {
   int16_t f = 1 - r;
   int16_t ddF_x = 1;
@@ -488,14 +526,29 @@ void Arduboy2Base::fillCircleHelper
 
     if (sides & 0x1) // right side
     {
-      drawFastVLine(x0+x, y0-y, 2*y+1+delta, color);
-      drawFastVLine(x0+y, y0-x, 2*x+1+delta, color);
+      fillColumn(x0+x, y0-y, 2*y+1+delta, color, patternColumn(pattern, x0+x));
     }
 
     if (sides & 0x2) // left side
     {
-      drawFastVLine(x0-x, y0-y, 2*y+1+delta, color);
-      drawFastVLine(x0-y, y0-x, 2*x+1+delta, color);
+      fillColumn(x0-x, y0-y, 2*y+1+delta, color, patternColumn(pattern, x0-x));
+    }
+
+    // The outer columns (x0 +/- y) get taller with each step until y
+    // changes, so each is drawn only once, at its full height, just before
+    // y moves on to the next column. Columns that x will reach are left
+    // for the code above.
+    if (f >= 0 && y > x + 1)
+    {
+      if (sides & 0x1) // right side
+      {
+        fillColumn(x0+y, y0-x, 2*x+1+delta, color, patternColumn(pattern, x0+y));
+      }
+
+      if (sides & 0x2) // left side
+      {
+        fillColumn(x0-y, y0-x, 2*x+1+delta, color, patternColumn(pattern, x0-y));
+      }
     }
   }
 }
@@ -503,6 +556,37 @@ void Arduboy2Base::fillCircleHelper
 void Arduboy2Base::drawLine
 (int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
 {
+  // horizontal and vertical lines are clipped and drawn a byte at a time
+  if (y0 == y1)
+  {
+    if (x0 > x1)
+      swap(x0, x1);
+    if (x0 < CLIP_LEFT)
+      x0 = CLIP_LEFT;
+    if (x1 > CLIP_RIGHT - 1)
+      x1 = CLIP_RIGHT - 1;
+    if (x0 <= x1)
+      drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+
+  if (x0 == x1)
+  {
+    if (y0 > y1)
+      swap(y0, y1);
+    if (y0 < CLIP_TOP)
+      y0 = CLIP_TOP;
+    if (y1 > CLIP_BOTTOM - 1)
+      y1 = CLIP_BOTTOM - 1;
+    if (y0 <= y1)
+      drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    return;
+  }
+
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(min(x0, x1), min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+  #endif
+
   // bresenham's algorithm - thx wikpedia
   bool steep = abs(y1 - y0) > abs(x1 - x0);
   if (steep) {
@@ -531,22 +615,168 @@ void Arduboy2Base::drawLine
     ystep = -1;
   }
 
-  for (; x0 <= x1; x0++)
+  // Clip to the display (or clip rectangle). The line is drawn from step
+  // kStart to kEnd, where step k plots the pixel at x = x0 + k. After k
+  // steps, y has moved m = ceil((k * dy - dx / 2) / dx) times (or 0 if
+  // that's negative), so the visible steps and the state at the first one
+  // can be calculated directly and the same pixels are drawn as for the
+  // unclipped line.
+  int16_t xMin = steep ? CLIP_TOP : CLIP_LEFT;
+  int16_t yMin = steep ? CLIP_LEFT : CLIP_TOP;
+  int16_t xMax = steep ? CLIP_BOTTOM - 1 : CLIP_RIGHT - 1;
+  int16_t yMax = steep ? CLIP_RIGHT - 1 : CLIP_BOTTOM - 1;
+
+  if (x1 < xMin || x0 > xMax)
+    return;
+
+  int16_t kStart = (x0 < xMin) ? xMin - x0 : 0;
+  int16_t kEnd = ((x1 > xMax) ? xMax : x1) - x0;
+
+  // the range of y moves (m) for which y is on the display
+  int16_t mLo, mHi;
+  if (ystep > 0)
+  {
+    mLo = yMin - y0;
+    mHi = yMax - y0;
+  }
+  else
+  {
+    mLo = y0 - yMax;
+    mHi = y0 - yMin;
+  }
+
+  if (mHi < 0 || mLo > dy)
+    return;
+
+  int16_t k;
+  if (mLo > 0)
   {
-    if (steep)
-    {
-      drawPixel(y0, x0, color);
-    }
-    else
+    // first step after y has moved mLo times
+    k = (((int32_t)(mLo - 1) * dx) + err) / dy + 1;
+    if (k > kStart)
+      kStart = k;
+  }
+  if (mHi < dy)
+  {
+    // last step before y moves more than mHi times
+    k = (((int32_t)mHi * dx) + err) / dy;
+    if (k < kEnd)
+      kEnd = k;
+  }
+
+  if (kStart > kEnd)
+    return;
+
+  if (kStart != 0)
+  {
+    int32_t moves = ((int32_t)kStart * dy) - err;
+    moves = (moves <= 0) ? 0 : (moves + dx - 1) / dx;
+    err += (moves * dx) - ((int32_t)kStart * dy);
+    x0 += kStart;
+    y0 += (ystep > 0) ? moves : -moves;
+  }
+
+  // All the pixels left are on the display, so the buffer is written
+  // directly, stepping the pointer and bit mask as the line moves.
+  uint8_t count = kEnd - kStart + 1;
+
+  if (!steep)
+  {
+    // One pixel per column, so each is written as it's reached
+    uint8_t *p = sBuffer + ((y0 / 8) * WIDTH) + x0;
+    uint8_t bit = 1 << (y0 & 7);
+
+    while (count--)
     {
-      drawPixel(x0, y0, color);
+      switch (color)
+      {
+        case WHITE:
+          *p |= bit;
+          break;
+
+        case BLACK:
+          *p &= ~bit;
+          break;
+
+        case INVERT:
+          *p ^= bit;
+          break;
+      }
+      p++;
+
+      err -= dy;
+      if (err < 0)
+      {
+        err += dx;
+        if (ystep > 0)
+        {
+          bit <<= 1;
+          if (bit == 0)
+          {
+            bit = 0x01;
+            p += WIDTH;
+          }
+        }
+        else
+        {
+          bit >>= 1;
+          if (bit == 0)
+          {
+            bit = 0x80;
+            p -= WIDTH;
+          }
+        }
+      }
     }
+  }
+  else
+  {
+    // Several pixels in a column can share a byte, so they're collected
+    // and written together when the column or page changes
+    uint8_t *p = sBuffer + ((x0 / 8) * WIDTH) + y0;
+    uint8_t bit = 1 << (x0 & 7);
+    uint8_t bits = 0;
 
-    err -= dy;
-    if (err < 0)
+    while (count--)
     {
-      y0 += ystep;
-      err += dx;
+      bits |= bit;
+      bit <<= 1;
+
+      err -= dy;
+      bool move = err < 0;
+      if (move)
+      {
+        err += dx;
+      }
+
+      if (move || bit == 0 || count == 0)
+      {
+        switch (color)
+        {
+          case WHITE:
+            *p |= bits;
+            break;
+
+          case BLACK:
+            *p &= ~bits;
+            break;
+
+          case INVERT:
+            *p ^= bits;
+            break;
+        }
+        bits = 0;
+      }
+
+      if (bit == 0)
+      {
+        bit = 0x01;
+        p += WIDTH;
+      }
+      if (move)
+      {
+        p += ystep;
+      }
     }
   }
 }
@@ -563,10 +793,110 @@ void Arduboy2Base::drawRect
 void Arduboy2Base::drawFastVLine
 (int16_t x, int16_t y, uint8_t h, uint8_t color)
 {
-  int end = y+h;
-  for (int a = max(0,y); a < min(end,HEIGHT); a++)
+  fillColumn(x, y, h, color, 0xFF);
+}
+
+void Arduboy2Base::fillColumn
+(int16_t x, int16_t y, uint8_t h, uint8_t color, uint8_t pattern)
+{
+  int16_t yEnd = y + h; // last y point + 1
+
+  // Do x bounds checks
+  if (x < CLIP_LEFT || x >= CLIP_RIGHT)
+    return;
+
+  // Clip to the display
+  if (y < CLIP_TOP)
+    y = CLIP_TOP;
+  if (yEnd > CLIP_BOTTOM)
+    yEnd = CLIP_BOTTOM;
+
+  if (y >= yEnd)
+    return;
+
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, 1, yEnd - y);
+  #endif
+
+  uint8_t page = y / 8;
+  uint8_t lastPage = (yEnd - 1) / 8;
+
+  // pixel masks for partial top and bottom pages, limited to the pattern
+  uint8_t mask = (0xFF << (y & 7)) & pattern;
+  uint8_t lastMask = (0xFF >> (7 - ((yEnd - 1) & 7))) & pattern;
+
+  uint8_t *p = sBuffer + (page * WIDTH) + x;
+
+  if (page == lastPage)
+  {
+    // the line is within a single page
+    mask &= lastMask;
+  }
+  else
+  {
+    // head: the partial (or full) top page
+    switch (color)
+    {
+      case WHITE:
+        *p |= mask;
+        break;
+
+      case BLACK:
+        *p &= ~mask;
+        break;
+
+      case INVERT:
+        *p ^= mask;
+        break;
+    }
+    p += WIDTH;
+
+    // whole pages in between
+    uint8_t data = (color == BLACK) ? 0x00 : 0xFF;
+    for (uint8_t i = lastPage - page - 1; i != 0; i--)
+    {
+      if (pattern == 0xFF && color != INVERT)
+      {
+        // whole bytes can be stored without reading the buffer
+        *p = data;
+      }
+      else
+      {
+        switch (color)
+        {
+          case WHITE:
+            *p |= pattern;
+            break;
+
+          case BLACK:
+            *p &= ~pattern;
+            break;
+
+          case INVERT:
+            *p ^= pattern;
+            break;
+        }
+      }
+      p += WIDTH;
+    }
+
+    mask = lastMask;
+  }
+
+  // tail: the partial (or full) bottom page
+  switch (color)
   {
-    drawPixel(x,a,color);
+    case WHITE:
+      *p |= mask;
+      break;
+
+    case BLACK:
+      *p &= ~mask;
+      break;
+
+    case INVERT:
+      *p ^= mask;
+      break;
   }
 }
 
@@ -576,26 +906,30 @@ void Arduboy2Base::drawFastHLine
   int16_t xEnd; // last x point + 1
 
   // Do y bounds checks
-  if (y < 0 || y >= HEIGHT)
+  if (y < CLIP_TOP || y >= CLIP_BOTTOM)
     return;
 
   xEnd = x + w;
 
   // Check if the entire line is not on the display
-  if (xEnd <= 0 || x >= WIDTH)
+  if (xEnd <= CLIP_LEFT || x >= CLIP_RIGHT)
     return;
 
   // Don't start before the left edge
-  if (x < 0)
-    x = 0;
+  if (x < CLIP_LEFT)
+    x = CLIP_LEFT;
 
   // Don't end past the right edge
-  if (xEnd > WIDTH)
-    xEnd = WIDTH;
+  if (xEnd > CLIP_RIGHT)
+    xEnd = CLIP_RIGHT;
 
   // calculate actual width (even if unchanged)
   w = xEnd - x;
 
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, w, 1);
+  #endif
+
   // buffer pointer plus row offset + x offset
   register uint8_t *pBuf = sBuffer + ((y / 8) * WIDTH) + x;
 
@@ -618,16 +952,193 @@ void Arduboy2Base::drawFastHLine
         *pBuf++ &= mask;
       }
       break;
+
+    case INVERT:
+      while (w--)
+      {
+        *pBuf++ ^= mask;
+      }
+      break;
   }
 }
 
 void Arduboy2Base::fillRect
 (int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
 {
-  // stupidest version - update in subclasses if desired!
-  for (int16_t i=x; i<x+w; i++)
+  int16_t xEnd = x + w; // last x point + 1
+  int16_t yEnd = y + h; // last y point + 1
+
+  // Clip to the display
+  if (x < CLIP_LEFT)
+    x = CLIP_LEFT;
+  if (y < CLIP_TOP)
+    y = CLIP_TOP;
+  if (xEnd > CLIP_RIGHT)
+    xEnd = CLIP_RIGHT;
+  if (yEnd > CLIP_BOTTOM)
+    yEnd = CLIP_BOTTOM;
+
+  // Nothing to draw if the clipped rectangle is empty (this also catches
+  // rectangles that are entirely off the display)
+  if (x >= xEnd || y >= yEnd)
+    return;
+
+  // calculate actual width (even if unchanged)
+  w = xEnd - x;
+
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, w, yEnd - y);
+  #endif
+
+  // pages (8 pixel high rows) of the top and bottom edges
+  uint8_t page = y / 8;
+  uint8_t lastPage = (yEnd - 1) / 8;
+
+  // pixel masks for partial top and bottom pages
+  uint8_t mask = 0xFF << (y & 7);
+  uint8_t lastMask = 0xFF >> (7 - ((yEnd - 1) & 7));
+
+  // buffer pointer plus row offset + x offset
+  uint8_t *pBuf = sBuffer + (page * WIDTH) + x;
+
+  while (true)
+  {
+    if (page == lastPage)
+    {
+      mask &= lastMask;
+    }
+
+    uint8_t *p = pBuf;
+    uint8_t i = w;
+
+    if (mask == 0xFF && color != INVERT)
+    {
+      // whole bytes can be stored without reading the buffer
+      uint8_t data = (color == BLACK) ? 0x00 : 0xFF;
+      while (i--)
+      {
+        *p++ = data;
+      }
+    }
+    else
+    {
+      switch (color)
+      {
+        case WHITE:
+          while (i--)
+          {
+            *p++ |= mask;
+          }
+          break;
+
+        case BLACK:
+          while (i--)
+          {
+            *p++ &= ~mask;
+          }
+          break;
+
+        case INVERT:
+          while (i--)
+          {
+            *p++ ^= mask;
+          }
+          break;
+      }
+    }
+
+    if (page == lastPage)
+    {
+      break;
+    }
+    page++;
+    pBuf += WIDTH;
+    mask = 0xFF;
+  }
+}
+
+void Arduboy2Base::fillRectPattern
+(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *pattern, uint8_t color)
+{
+  int16_t xEnd = x + w; // last x point + 1
+  int16_t yEnd = y + h; // last y point + 1
+
+  // Clip to the display
+  if (x < CLIP_LEFT)
+    x = CLIP_LEFT;
+  if (y < CLIP_TOP)
+    y = CLIP_TOP;
+  if (xEnd > CLIP_RIGHT)
+    xEnd = CLIP_RIGHT;
+  if (yEnd > CLIP_BOTTOM)
+    yEnd = CLIP_BOTTOM;
+
+  if (x >= xEnd || y >= yEnd)
+    return;
+
+  w = xEnd - x;
+
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(x, y, w, yEnd - y);
+  #endif
+
+  // copy the pattern to RAM, rotated to start at the first column
+  uint8_t columns[8];
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    columns[i] = pgm_read_byte(pattern + ((x + i) & 7));
+  }
+
+  uint8_t page = y / 8;
+  uint8_t lastPage = (yEnd - 1) / 8;
+
+  // pixel masks for partial top and bottom pages
+  uint8_t mask = 0xFF << (y & 7);
+  uint8_t lastMask = 0xFF >> (7 - ((yEnd - 1) & 7));
+
+  uint8_t *pBuf = sBuffer + (page * WIDTH) + x;
+
+  while (true)
   {
-    drawFastVLine(i, y, h, color);
+    if (page == lastPage)
+    {
+      mask &= lastMask;
+    }
+
+    uint8_t *p = pBuf;
+    uint8_t i;
+
+    switch (color)
+    {
+      case WHITE:
+        for (i = 0; i < w; i++)
+        {
+          *p++ |= columns[i & 7] & mask;
+        }
+        break;
+
+      case BLACK:
+        for (i = 0; i < w; i++)
+        {
+          *p++ &= ~(columns[i & 7] & mask);
+        }
+        break;
+
+      case INVERT:
+        for (i = 0; i < w; i++)
+        {
+          *p++ ^= columns[i & 7] & mask;
+        }
+        break;
+    }
+
+    if (page == lastPage)
+    {
+      break;
+    }
+    page++;
+    pBuf += WIDTH;
+    mask = 0xFF;
   }
 }
 
@@ -649,6 +1160,10 @@ void Arduboy2Base::fillScreen(uint8_t color)
   // screen buffer size.
   // It also assumes color value for BLACK is 0.
 
+  #ifdef DIRTY_TRACKING_MODE
+  markDirty(0, 0, WIDTH, HEIGHT);
+  #endif
+
   // local variable for screen buffer pointer,
   // which can be declared a read-write operand
   uint8_t* bPtr = sBuffer;
@@ -679,6 +1194,43 @@ void Arduboy2Base::fillScreen(uint8_t color)
   );
 }
 
+void Arduboy2Base::fillScreenPattern(const uint8_t *pattern, uint8_t color)
+{
+  fillRectPattern(0, 0, WIDTH, HEIGHT, pattern, color);
+}
+
+// Ordered dither patterns from a 4x4 Bayer matrix, tiled to 8x8, from 0/16
+// to 16/16 of the pixels set. Each byte is one column of 8 vertical pixels.
+static const uint8_t PROGMEM ditherPatterns[17][8] =
+{
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+  { 0x11, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00 },
+  { 0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00 },
+  { 0x11, 0x00, 0x55, 0x00, 0x11, 0x00, 0x55, 0x00 },
+  { 0x55, 0x00, 0x55, 0x00, 0x55, 0x00, 0x55, 0x00 },
+  { 0x55, 0x22, 0x55, 0x00, 0x55, 0x22, 0x55, 0x00 },
+  { 0x55, 0x22, 0x55, 0x88, 0x55, 0x22, 0x55, 0x88 },
+  { 0x55, 0x22, 0x55, 0xAA, 0x55, 0x22, 0x55, 0xAA },
+  { 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA },
+  { 0x55, 0xBB, 0x55, 0xAA, 0x55, 0xBB, 0x55, 0xAA },
+  { 0x55, 0xBB, 0x55, 0xEE, 0x55, 0xBB, 0x55, 0xEE },
+  { 0x55, 0xBB, 0x55, 0xFF, 0x55, 0xBB, 0x55, 0xFF },
+  { 0x55, 0xFF, 0x55, 0xFF, 0x55, 0xFF, 0x55, 0xFF },
+  { 0x77, 0xFF, 0x55, 0xFF, 0x77, 0xFF, 0x55, 0xFF },
+  { 0x77, 0xFF, 0xDD, 0xFF, 0x77, 0xFF, 0xDD, 0xFF },
+  { 0x77, 0xFF, 0xFF, 0xFF, 0x77, 0xFF, 0xFF, 0xFF },
+  { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }
+};
+
+const uint8_t *Arduboy2Base::ditherPattern(uint8_t level)
+{
+  if (level > 16)
+  {
+    level = 16;
+  }
+  return ditherPatterns[level];
+}
+
 void Arduboy2Base::drawRoundRect
 (int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r, uint8_t color)
 {
@@ -705,6 +1257,17 @@ void Arduboy2Base::fillRoundRect
   fillCircleHelper(x+r, y+r, r, 2, h-2*r-1, color);
 }
 
+void Arduboy2Base::fillRoundRectPattern
+(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r, const uint8_t *pattern,
+ uint8_t color)
+{
+  fillRectPattern(x+r, y, w-2*r, h, pattern, color);
+
+  // draw four corners
+  fillCircleHelper(x+w-r-1, y+r, r, 1, h-2*r-1, color, pattern);
+  fillCircleHelper(x+r, y+r, r, 2, h-2*r-1, color, pattern);
+}
+
 void Arduboy2Base::drawTriangle
 (int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
 {
@@ -716,42 +1279,75 @@ void Arduboy2Base::drawTriangle
 void Arduboy2Base::fillTriangle
 (int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
 {
+  fillTriangleSpans(x0, y0, x1, y1, x2, y2, color, NULL);
+}
+
+void Arduboy2Base::fillTrianglePattern
+(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+ const uint8_t *pattern, uint8_t color)
+{
+  fillTriangleSpans(x0, y0, x1, y1, x2, y2, color, pattern);
+}
+
+void Arduboy2Base::fillTriangleSpans
+(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+ uint8_t color, const uint8_t *pattern)
+{
+  // The triangle is drawn as vertical spans, one per column, so each byte
+  // of the display buffer is written only once.
 
-  int16_t a, b, y, last;
-  // Sort coordinates by Y order (y2 >= y1 >= y0)
-  if (y0 > y1)
+  int16_t a, b, x, last;
+  // Sort coordinates by X order (x2 >= x1 >= x0)
+  if (x0 > x1)
   {
-    swap(y0, y1); swap(x0, x1);
+    swap(x0, x1); swap(y0, y1);
   }
-  if (y1 > y2)
+  if (x1 > x2)
   {
-    swap(y2, y1); swap(x2, x1);
+    swap(x2, x1); swap(y2, y1);
   }
-  if (y0 > y1)
+  if (x0 > x1)
   {
-    swap(y0, y1); swap(x0, x1);
+    swap(x0, x1); swap(y0, y1);
   }
 
-  if(y0 == y2)
-  { // Handle awkward all-on-same-line case as its own thing
-    a = b = x0;
-    if(x1 < a)
+  // Nothing to draw if the triangle is entirely off the display
+  if (x2 < CLIP_LEFT || x0 >= CLIP_RIGHT ||
+      (y0 < CLIP_TOP && y1 < CLIP_TOP && y2 < CLIP_TOP) ||
+      (y0 >= CLIP_BOTTOM && y1 >= CLIP_BOTTOM &&
+       y2 >= CLIP_BOTTOM))
+  {
+    return;
+  }
+
+  if(x0 == x2)
+  { // Handle awkward all-in-same-column case as its own thing
+    a = b = y0;
+    if(y1 < a)
+    {
+      a = y1;
+    }
+    else if(y1 > b)
+    {
+      b = y1;
+    }
+    if(y2 < a)
     {
-      a = x1;
+      a = y2;
     }
-    else if(x1 > b)
+    else if(y2 > b)
     {
-      b = x1;
+      b = y2;
     }
-    if(x2 < a)
+    if (a < CLIP_TOP)
     {
-      a = x2;
+      a = CLIP_TOP;
     }
-    else if(x2 > b)
+    if (b > CLIP_BOTTOM - 1)
     {
-      b = x2;
+      b = CLIP_BOTTOM - 1;
     }
-    drawFastHLine(a, y0, b-a+1, color);
+    fillColumn(x0, a, b-a+1, color, patternColumn(pattern, x0));
     return;
   }
 
@@ -761,69 +1357,468 @@ void Arduboy2Base::fillTriangle
       dy02 = y2 - y0,
       dx12 = x2 - x1,
       dy12 = y2 - y1,
-      sa = 0,
-      sb = 0;
-
-  // For upper part of triangle, find scanline crossings for segments
-  // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
-  // is included here (and second loop will be skipped, avoiding a /0
-  // error there), otherwise scanline y1 is skipped here and handled
-  // in the second loop...which also avoids a /0 error here if y0=y1
-  // (flat-topped triangle).
-  if (y1 == y2)
+      sa,
+      sb;
+
+  // For the left part of triangle, find column crossings for segments
+  // 0-1 and 0-2.  If x1=x2 (flat-right triangle), column x1 is included
+  // here (and second loop will be skipped, avoiding a /0 error there),
+  // otherwise column x1 is skipped here and handled in the second
+  // loop...which also avoids a /0 error here if x0=x1 (flat-left
+  // triangle).
+  if (x1 == x2)
   {
-    last = y1;   // Include y1 scanline
+    last = x1;   // Include x1 column
   }
   else
   {
-    last = y1-1; // Skip it
+    last = x1-1; // Skip it
   }
 
+  // Columns off the left and right edges are skipped
+  if (last > CLIP_RIGHT - 1)
+  {
+    last = CLIP_RIGHT - 1;
+  }
+  x = (x0 < CLIP_LEFT) ? CLIP_LEFT : x0;
+  sa = dy01 * (x - x0);
+  sb = dy02 * (x - x0);
 
-  for(y = y0; y <= last; y++)
+  for(; x <= last; x++)
   {
-    a   = x0 + sa / dy01;
-    b   = x0 + sb / dy02;
-    sa += dx01;
-    sb += dx02;
+    a   = y0 + sa / dx01;
+    b   = y0 + sb / dx02;
+    sa += dy01;
+    sb += dy02;
 
     if(a > b)
     {
       swap(a,b);
     }
+    if (a < CLIP_TOP)
+    {
+      a = CLIP_TOP;
+    }
+    if (b > CLIP_BOTTOM - 1)
+    {
+      b = CLIP_BOTTOM - 1;
+    }
+    if (a <= b)
+    {
+      fillColumn(x, a, b-a+1, color, patternColumn(pattern, x));
+    }
+  }
+
+  // For the right part of triangle, find column crossings for segments
+  // 0-2 and 1-2.  This loop is skipped if x1=x2.
+  last = (x2 > CLIP_RIGHT - 1) ? CLIP_RIGHT - 1 : x2;
+  sa = dy12 * (x - x1);
+  sb = dy02 * (x - x0);
+
+  for(; x <= last; x++)
+  {
+    a   = y1 + sa / dx12;
+    b   = y0 + sb / dx02;
+    sa += dy12;
+    sb += dy02;
 
-    drawFastHLine(a, y, b-a+1, color);
-  }
-
-  // For lower part of triangle, find scanline crossings for segments
-  // 0-2 and 1-2.  This loop is skipped if y1=y2.
-  sa = dx12 * (y - y1);
-  sb = dx02 * (y - y0);
-
-  for(; y <= y2; y++)
-  {
-    a   = x1 + sa / dy12;
-    b   = x0 + sb / dy02;
-    sa += dx12;
-    sb += dx02;
-
     if(a > b)
     {
       swap(a,b);
     }
+    if (a < CLIP_TOP)
+    {
+      a = CLIP_TOP;
+    }
+    if (b > CLIP_BOTTOM - 1)
+    {
+      b = CLIP_BOTTOM - 1;
+    }
+    if (a <= b)
+    {
+      fillColumn(x, a, b-a+1, color, patternColumn(pattern, x));
+    }
+  }
+}
 
-    drawFastHLine(a, y, b-a+1, color);
+// Helpers for the polygon functions
+
+// The most edges of a polygon that can cross a single column for
+// fillPolygon(). Further edges are ignored.
+#define POLYGON_MAX_EDGES 8
+
+static Point readPolygonPoint(const Point *points, uint8_t i, bool inProgmem)
+{
+  if (inProgmem)
+  {
+    return Point(pgm_read_word(&points[i].x), pgm_read_word(&points[i].y));
   }
+  return points[i];
 }
 
-void Arduboy2Base::drawBitmap
+// Steps along an edge of a polygon one column at a time, giving the Y
+// coordinate of the edge, rounded to the nearest pixel, at each column
+struct PolygonEdge
+{
+  int16_t y;         // Y at the current column
+  int16_t yStep;     // whole part of the change in Y per column
+  uint16_t fracStep; // fractional part of the change, in 1/dx units
+  uint16_t frac;     // fractional part of Y, in 1/dx units
+  uint16_t dx;
+  int16_t xEnd;      // the last column of the edge
+
+  // Start at column x of the edge from a to b, where a.x <= x
+  void start(Point a, Point b, int16_t x)
+  {
+    xEnd = b.x;
+    dx = b.x - a.x;
+    if (dx == 0)
+    {
+      y = b.y;
+      yStep = 0;
+      fracStep = 0;
+      frac = 0;
+      dx = 1;
+      return;
+    }
+
+    int16_t dy = b.y - a.y;
+    yStep = dy / (int16_t)dx;
+    int16_t r = dy % (int16_t)dx;
+    if (r < 0)
+    {
+      r += dx;
+      yStep--;
+    }
+    fracStep = r;
+
+    // Y = a.y + floor(((x - a.x) * dy + dx / 2) / dx)
+    if (x == a.x)
+    {
+      y = a.y;
+      frac = dx / 2;
+    }
+    else
+    {
+      int32_t num = ((int32_t)(x - a.x) * dy) + (dx / 2);
+      int32_t q = num / dx;
+      int32_t rem = num % dx;
+      if (rem < 0)
+      {
+        rem += dx;
+        q--;
+      }
+      y = a.y + q;
+      frac = rem;
+    }
+  }
+
+  void step()
+  {
+    y += yStep;
+    frac += fracStep;
+    if (frac >= dx)
+    {
+      frac -= dx;
+      y++;
+    }
+  }
+};
+
+void Arduboy2Base::drawPolygon(const Point *points, uint8_t count, uint8_t color)
+{
+  polygonOutline(points, count, color, false);
+}
+
+void Arduboy2Base::drawPolygon_P(const Point *points, uint8_t count, uint8_t color)
+{
+  polygonOutline(points, count, color, true);
+}
+
+void Arduboy2Base::fillPolygon(const Point *points, uint8_t count, uint8_t color)
+{
+  polygonFill(points, count, color, false);
+}
+
+void Arduboy2Base::fillPolygon_P(const Point *points, uint8_t count, uint8_t color)
+{
+  polygonFill(points, count, color, true);
+}
+
+void Arduboy2Base::fillConvexPolygon(const Point *points, uint8_t count, uint8_t color)
+{
+  convexPolygonFill(points, count, color, false);
+}
+
+void Arduboy2Base::fillConvexPolygon_P(const Point *points, uint8_t count, uint8_t color)
+{
+  convexPolygonFill(points, count, color, true);
+}
+
+void Arduboy2Base::polygonOutline
+(const Point *points, uint8_t count, uint8_t color, bool inProgmem)
+{
+  if (count == 0)
+    return;
+
+  Point a = readPolygonPoint(points, count - 1, inProgmem);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    Point b = readPolygonPoint(points, i, inProgmem);
+    drawLine(a.x, a.y, b.x, b.y, color);
+    a = b;
+  }
+}
+
+void Arduboy2Base::polygonFill
+(const Point *points, uint8_t count, uint8_t color, bool inProgmem)
+{
+  if (count == 0)
+    return;
+
+  // find the bounds of the polygon
+  Point p = readPolygonPoint(points, 0, inProgmem);
+  int16_t minX = p.x, maxX = p.x, minY = p.y, maxY = p.y;
+  for (uint8_t i = 1; i < count; i++)
+  {
+    p = readPolygonPoint(points, i, inProgmem);
+    if (p.x < minX)
+      minX = p.x;
+    if (p.x > maxX)
+      maxX = p.x;
+    if (p.y < minY)
+      minY = p.y;
+    if (p.y > maxY)
+      maxY = p.y;
+  }
+
+  // Nothing to draw if the polygon is entirely off the display
+  if (maxX < CLIP_LEFT || minX >= CLIP_RIGHT ||
+      maxY < CLIP_TOP || minY >= CLIP_BOTTOM)
+    return;
+
+  if (minX == maxX)
+  { // Handle awkward all-in-same-column case as its own thing
+    if (minY < CLIP_TOP)
+      minY = CLIP_TOP;
+    if (maxY > CLIP_BOTTOM - 1)
+      maxY = CLIP_BOTTOM - 1;
+    drawFastVLine(minX, minY, maxY - minY + 1, color);
+    return;
+  }
+
+  // Columns off the left and right edges are skipped
+  int16_t x = (minX < CLIP_LEFT) ? CLIP_LEFT : minX;
+  int16_t xLast = (maxX > CLIP_RIGHT - 1) ? CLIP_RIGHT - 1 : maxX;
+
+  // The active edge table: the edges crossing the current column.
+  // An edge covers the columns from its left end up to, but not including,
+  // its right end, so each vertex is only counted once. The exception is
+  // the polygon's last column, which has only the edges ending there.
+  PolygonEdge edges[POLYGON_MAX_EDGES];
+  uint8_t active = 0;
+  int16_t nextStart = x; // the next column where an edge starts
+
+  for (; x <= xLast; x++)
+  {
+    // remove edges that have ended
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < active; i++)
+    {
+      if (edges[i].xEnd > x || x == maxX)
+      {
+        edges[n++] = edges[i];
+      }
+    }
+    active = n;
+
+    // add edges that start at this column (or before it, for the first)
+    if (x == nextStart)
+    {
+      nextStart = maxX + 1;
+      Point a = readPolygonPoint(points, count - 1, inProgmem);
+      for (uint8_t i = 0; i < count; i++)
+      {
+        Point b = readPolygonPoint(points, i, inProgmem);
+        Point left = (a.x < b.x) ? a : b;
+        Point right = (a.x < b.x) ? b : a;
+        a = b;
+
+        if (left.x > x)
+        {
+          if (left.x < nextStart)
+            nextStart = left.x;
+        }
+        else if ((left.x == x || x == 0) &&
+                 (right.x > x || (right.x == x && x == maxX && left.x < x)) &&
+                 active < POLYGON_MAX_EDGES)
+        {
+          edges[active++].start(left, right, x);
+        }
+      }
+    }
+
+    // sort the crossings by Y
+    int16_t ys[POLYGON_MAX_EDGES];
+    for (uint8_t i = 0; i < active; i++)
+    {
+      int16_t y = edges[i].y;
+      uint8_t j = i;
+      while (j > 0 && ys[j - 1] > y)
+      {
+        ys[j] = ys[j - 1];
+        j--;
+      }
+      ys[j] = y;
+      edges[i].step();
+    }
+
+    // fill between each pair of crossings
+    for (uint8_t i = 1; i < active; i += 2)
+    {
+      int16_t a = ys[i - 1];
+      int16_t b = ys[i];
+      if (a < CLIP_TOP)
+        a = CLIP_TOP;
+      if (b > CLIP_BOTTOM - 1)
+        b = CLIP_BOTTOM - 1;
+      if (a <= b)
+        drawFastVLine(x, a, b - a + 1, color);
+    }
+  }
+}
+
+void Arduboy2Base::convexPolygonFill
+(const Point *points, uint8_t count, uint8_t color, bool inProgmem)
+{
+  if (count == 0)
+    return;
+
+  // find the leftmost and rightmost points and the bounds of the polygon
+  uint8_t leftIndex = 0, rightIndex = 0;
+  Point p = readPolygonPoint(points, 0, inProgmem);
+  int16_t minX = p.x, maxX = p.x, minY = p.y, maxY = p.y;
+  for (uint8_t i = 1; i < count; i++)
+  {
+    p = readPolygonPoint(points, i, inProgmem);
+    if (p.x < minX)
+    {
+      minX = p.x;
+      leftIndex = i;
+    }
+    if (p.x > maxX)
+    {
+      maxX = p.x;
+      rightIndex = i;
+    }
+    if (p.y < minY)
+      minY = p.y;
+    if (p.y > maxY)
+      maxY = p.y;
+  }
+
+  // Nothing to draw if the polygon is entirely off the display
+  if (maxX < CLIP_LEFT || minX >= CLIP_RIGHT ||
+      maxY < CLIP_TOP || minY >= CLIP_BOTTOM)
+    return;
+
+  if (minX == maxX)
+  { // Handle awkward all-in-same-column case as its own thing
+    if (minY < CLIP_TOP)
+      minY = CLIP_TOP;
+    if (maxY > CLIP_BOTTOM - 1)
+      maxY = CLIP_BOTTOM - 1;
+    drawFastVLine(minX, minY, maxY - minY + 1, color);
+    return;
+  }
+
+  // Columns off the left and right edges are skipped
+  int16_t x = (minX < CLIP_LEFT) ? CLIP_LEFT : minX;
+  int16_t xLast = (maxX > CLIP_RIGHT - 1) ? CLIP_RIGHT - 1 : maxX;
+
+  // The outline is split into two chains of edges from the leftmost point
+  // to the rightmost, one going each way around. Each column is filled
+  // between the two chains, including any vertical edges at that column.
+  PolygonEdge edges[2];
+  uint8_t ends[2]; // the point at the right end of each chain's edge
+  Point left = readPolygonPoint(points, leftIndex, inProgmem);
+
+  for (uint8_t c = 0; c < 2; c++)
+  {
+    edges[c].start(left, left, left.x);
+    ends[c] = leftIndex;
+  }
+
+  for (; x <= xLast; x++)
+  {
+    int16_t a = maxY;
+    int16_t b = minY;
+
+    for (uint8_t c = 0; c < 2; c++)
+    {
+      // move on to the edges that cross this column
+      while (edges[c].xEnd <= x && ends[c] != rightIndex)
+      {
+        if (edges[c].xEnd == x)
+        {
+          if (edges[c].y < a)
+            a = edges[c].y;
+          if (edges[c].y > b)
+            b = edges[c].y;
+        }
+
+        Point from = readPolygonPoint(points, ends[c], inProgmem);
+        if (c == 0)
+        {
+          ends[c] = (ends[c] == count - 1) ? 0 : ends[c] + 1;
+        }
+        else
+        {
+          ends[c] = (ends[c] == 0) ? count - 1 : ends[c] - 1;
+        }
+        Point to = readPolygonPoint(points, ends[c], inProgmem);
+
+        if (to.x >= x)
+        {
+          edges[c].start(from, to, x);
+        }
+        else
+        {
+          // the edge is entirely left of the display
+          edges[c].xEnd = to.x;
+        }
+      }
+
+      if (edges[c].y < a)
+        a = edges[c].y;
+      if (edges[c].y > b)
+        b = edges[c].y;
+      edges[c].step();
+    }
+
+    if (a < CLIP_TOP)
+      a = CLIP_TOP;
+    if (b > CLIP_BOTTOM - 1)
+      b = CLIP_BOTTOM - 1;
+    if (a <= b)
+      drawFastVLine(x, a, b - a + 1, color);
+  }
+}
+
+template<bool inProgmem>
+void Arduboy2Base::bitmapDraw
 (int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
  uint8_t color)
 {
   // no need to draw at all if we're offscreen
-  if (x+w < 0 || x > WIDTH-1 || y+h < 0 || y > HEIGHT-1)
+  if (x+w < CLIP_LEFT || x > CLIP_RIGHT-1 || y+h < CLIP_TOP || y > CLIP_BOTTOM-1)
     return;
 
+  #ifdef DIRTY_TRACKING_MODE
+  // the bitmap is drawn in whole bytes, so round the height up
+  markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
   int yOffset = abs(y) % 8;
   int sRow = y / 8;
   if (y < 0) {
@@ -832,41 +1827,114 @@ void Arduboy2Base::drawBitmap
   }
   int rows = h/8;
   if (h%8!=0) rows++;
+
+  // the visible columns of the bitmap and pages of the screen
+  int colStart = (x < CLIP_LEFT) ? CLIP_LEFT - x : 0;
+  int colEnd = (x + w > CLIP_RIGHT) ? CLIP_RIGHT - x : w;
+  int firstPage = CLIP_TOP / 8;
+  int lastPage = (CLIP_BOTTOM - 1) / 8;
+
   for (int a = 0; a < rows; a++) {
     int bRow = sRow + a;
-    if (bRow > (HEIGHT/8)-1) break;
-    if (bRow > -2) {
-      for (int iCol = 0; iCol<w; iCol++) {
-        if (iCol + x > (WIDTH-1)) break;
-        if (iCol + x >= 0) {
-          if (bRow >= 0) {
-            if (color == WHITE)
-              sBuffer[(bRow*WIDTH) + x + iCol] |= pgm_read_byte(bitmap+(a*w)+iCol) << yOffset;
-            else if (color == BLACK)
-              sBuffer[(bRow*WIDTH) + x + iCol] &= ~(pgm_read_byte(bitmap+(a*w)+iCol) << yOffset);
-            else
-              sBuffer[(bRow*WIDTH) + x + iCol] ^= pgm_read_byte(bitmap+(a*w)+iCol) << yOffset;
-          }
-          if (yOffset && bRow<(HEIGHT/8)-1 && bRow > -2) {
-            if (color == WHITE)
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] |= pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset);
-            else if (color == BLACK)
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] &= ~(pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset));
-            else
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] ^= pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset);
-          }
+    if (bRow > lastPage) break;
+    if (bRow >= firstPage - 1) {
+      uint8_t mask = 0xFF;
+      uint8_t nextMask = 0xFF;
+      #ifdef CLIP_RECT_MODE
+      mask = clipPageMask(bRow);
+      nextMask = clipPageMask(bRow + 1);
+      #endif
+      for (int iCol = colStart; iCol < colEnd; iCol++) {
+        // inProgmem is a constant, so only one of the reads is compiled
+        uint8_t data = inProgmem ? pgm_read_byte(bitmap+(a*w)+iCol) : bitmap[(a*w)+iCol];
+        if (bRow >= firstPage) {
+          uint8_t bits = (data << yOffset) & mask;
+          if (color == WHITE)
+            sBuffer[(bRow*WIDTH) + x + iCol] |= bits;
+          else if (color == BLACK)
+            sBuffer[(bRow*WIDTH) + x + iCol] &= ~bits;
+          else
+            sBuffer[(bRow*WIDTH) + x + iCol] ^= bits;
+        }
+        if (yOffset && bRow < lastPage) {
+          uint8_t bits = (data >> (8-yOffset)) & nextMask;
+          if (color == WHITE)
+            sBuffer[((bRow+1)*WIDTH) + x + iCol] |= bits;
+          else if (color == BLACK)
+            sBuffer[((bRow+1)*WIDTH) + x + iCol] &= ~bits;
+          else
+            sBuffer[((bRow+1)*WIDTH) + x + iCol] ^= bits;
         }
       }
     }
   }
 }
 
+void Arduboy2Base::drawBitmap
+(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
+ uint8_t color)
+{
+  bitmapDraw<true>(x, y, bitmap, w, h, color);
+}
+
+void Arduboy2Base::drawBitmapRAM
+(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
+ uint8_t color)
+{
+  bitmapDraw<false>(x, y, bitmap, w, h, color);
+}
+
+// Helpers for the scaled drawing functions
+
+// each nibble value with every bit doubled
+static const uint8_t doubledNibbles[16] PROGMEM = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+  0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
+uint8_t Arduboy2Base::scaleBits(uint8_t bits, uint8_t shift, uint8_t part)
+{
+  if (shift == 1)
+    return pgm_read_byte(doubledNibbles + ((part ? bits >> 4 : bits) & 0x0F));
+
+  bits = pgm_read_byte(doubledNibbles + ((bits >> (part * 2)) & 0x03));
+  return pgm_read_byte(doubledNibbles + bits);
+}
+
+// the rows of a page of the display buffer that can be drawn on
+static uint8_t drawablePageRows(int16_t page)
+{
+  #ifdef CLIP_RECT_MODE
+  return Arduboy2Base::clipPageMask(page);
+  #else
+  return (page >= 0 && page < HEIGHT / 8) ? 0xFF : 0x00;
+  #endif
+}
+
+void Arduboy2Base::drawBitmapScaled
+(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
+ uint8_t scale, uint8_t color)
+{
+  if (scale != 2 && scale != 4)
+  {
+    drawBitmap(x, y, bitmap, w, h, color);
+    return;
+  }
+
+  // The bitmap is drawn as a self masked sprite, which sets, clears or
+  // inverts the pixels of the bits set to 1
+  Sprites::drawBitmapScaled(x, y, bitmap, NULL, w, h,
+                            color == WHITE ? SPRITE_IS_MASK :
+                            color == BLACK ? SPRITE_IS_MASK_ERASE :
+                            SPRITE_IS_MASK_INVERT,
+                            scale);
+}
 
 void Arduboy2Base::drawSlowXYBitmap
 (int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color)
 {
   // no need to draw at all of we're offscreen
-  if (x+w < 0 || x > WIDTH-1 || y+h < 0 || y > HEIGHT-1)
+  if (x+w < CLIP_LEFT || x > CLIP_RIGHT-1 || y+h < CLIP_TOP || y > CLIP_BOTTOM-1)
     return;
 
   int16_t xi, yi, byteWidth = (w + 7) / 8;
@@ -880,38 +1948,152 @@ void Arduboy2Base::drawSlowXYBitmap
 }
 
 
-// Helper for drawCompressed()
+// Helpers for drawCompressed()
 struct BitStreamReader
 {
   const uint8_t *source;
-  uint16_t sourceIndex;
-  uint8_t bitBuffer;
-  uint8_t byteBuffer;
+  uint8_t byteBuffer; // the bits of the current byte that haven't been read
+  uint8_t bitsLeft;   // the number of bits left in byteBuffer
 
   BitStreamReader(const uint8_t *source)
-    : source(source), sourceIndex(), bitBuffer(), byteBuffer()
+    : source(source), byteBuffer(), bitsLeft()
   {
   }
 
-  uint16_t readBits(uint16_t bitCount)
+  // Read up to 16 bits, least significant first. As many bits as possible
+  // are taken from each byte at once.
+  uint16_t readBits(uint8_t bitCount)
   {
     uint16_t result = 0;
-    for (uint16_t i = 0; i < bitCount; i++)
+    uint8_t shift = 0;
+
+    while (bitCount != 0)
     {
-      if (this->bitBuffer == 0)
+      if (this->bitsLeft == 0)
       {
-        this->bitBuffer = 0x1;
-        this->byteBuffer = pgm_read_byte(&this->source[this->sourceIndex]);
-        ++this->sourceIndex;
+        this->byteBuffer = pgm_read_byte(this->source++);
+        this->bitsLeft = 8;
       }
 
-      if ((this->byteBuffer & this->bitBuffer) != 0)
-        result |= (1 << i);
+      uint8_t n = (bitCount < this->bitsLeft) ? bitCount : this->bitsLeft;
 
-      this->bitBuffer <<= 1;
+      result |= (uint16_t)(this->byteBuffer & (0xFF >> (8 - n))) << shift;
+      this->byteBuffer >>= n;
+      this->bitsLeft -= n;
+      bitCount -= n;
+      shift += n;
     }
     return result;
   }
+
+  // Read a span length. Each 0 bit before the first 1 bit adds 2 to the
+  // number of bits used for the length.
+  uint16_t readSpanLength()
+  {
+    uint8_t bitLength = 1;
+
+    // skip whole bytes of 0 bits at once
+    while (true)
+    {
+      if (this->bitsLeft == 0)
+      {
+        this->byteBuffer = pgm_read_byte(this->source++);
+        this->bitsLeft = 8;
+      }
+      if (this->byteBuffer != 0)
+        break;
+      bitLength += this->bitsLeft * 2;
+      this->bitsLeft = 0;
+    }
+
+    while ((this->byteBuffer & 0x01) == 0)
+    {
+      this->byteBuffer >>= 1;
+      this->bitsLeft--;
+      bitLength += 2;
+    }
+    // drop the 1 bit
+    this->byteBuffer >>= 1;
+    this->bitsLeft--;
+
+    return readBits(bitLength) + 1;
+  }
+};
+
+struct CompressedWriter
+{
+  int16_t x;         // the screen X coordinate of the left side of the image
+  int8_t row;        // the screen page of the current image row
+  uint8_t yOffset;   // the number of pixels rows are shifted down by
+  uint8_t color;
+  uint16_t width;
+  uint16_t column;   // the current column of the image
+  uint8_t rowsLeft;  // the number of visible (or above the screen) rows left
+
+  // Write count bytes of the same value, moving to the next row at the end
+  // of each row. Bytes that are off the screen, or have no bits set (so
+  // wouldn't change anything) are skipped without touching the buffer.
+  // Returns false when there's nothing more on the screen to draw.
+  bool write(uint8_t value, uint16_t count)
+  {
+    while (count != 0)
+    {
+      uint16_t n = this->width - this->column;
+      if (count < n)
+        n = count;
+
+      if (value != 0 && this->row > -2)
+      {
+        int16_t start = this->x + this->column;
+        int16_t end = start + n;
+
+        if (start < CLIP_LEFT)
+          start = CLIP_LEFT;
+        if (end > CLIP_RIGHT)
+          end = CLIP_RIGHT;
+
+        if (start < end)
+        {
+          uint8_t upper = value << this->yOffset;
+          uint8_t lower = value >> (8 - this->yOffset);
+          #ifdef CLIP_RECT_MODE
+          upper &= Arduboy2Base::clipPageMask(this->row);
+          lower &= Arduboy2Base::clipPageMask(this->row + 1);
+          #endif
+          uint8_t *p = Arduboy2Base::sBuffer + (this->row * WIDTH) + start;
+
+          if (this->row >= 0)
+            drawSpan(p, end - start, upper);
+          if (lower != 0 && this->row < (HEIGHT / 8) - 1)
+            drawSpan(p + WIDTH, end - start, lower);
+        }
+      }
+
+      this->column += n;
+      count -= n;
+      if (this->column == this->width)
+      {
+        this->column = 0;
+        this->row++;
+        if (--this->rowsLeft == 0)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void drawSpan(uint8_t *p, uint8_t count, uint8_t bits)
+  {
+    if (this->color != BLACK)
+    {
+      do { *p++ |= bits; } while (--count != 0);
+    }
+    else
+    {
+      bits = ~bits;
+      do { *p++ &= bits; } while (--count != 0);
+    }
+  }
 };
 
 void Arduboy2Base::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap, uint8_t color)
@@ -925,86 +2107,74 @@ void Arduboy2Base::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap,
   uint8_t spanColour = (uint8_t)cs.readBits(1); // starting colour
 
   // no need to draw at all if we're offscreen
-  if ((sx + width < 0) || (sx > WIDTH - 1) || (sy + height < 0) || (sy > HEIGHT - 1))
+  if ((sx + width < CLIP_LEFT) || (sx > CLIP_RIGHT - 1) ||
+      (sy + height < CLIP_TOP) || (sy > CLIP_BOTTOM - 1))
     return;
 
-  // sy = sy - (frame * height);
-  int yOffset = abs(sy) % 8;
-  int startRow = sy / 8;
-  if (sy < 0) {
-    startRow--;
-    yOffset = 8 - yOffset;
-  }
-  int rows = height / 8;
-  if ((height % 8) != 0)
-    ++rows;
-
-  int rowOffset = 0; // +(frame*rows);
-  int columnOffset = 0;
+  #ifdef DIRTY_TRACKING_MODE
+  // the image is drawn in whole bytes, so round the height up
+  markDirty(sx, sy, width, (height + 7) & ~7);
+  #endif
 
+  CompressedWriter out;
+  out.x = sx;
+  out.yOffset = sy & 7;
+  out.row = sy / 8;
+  if (sy < 0 && out.yOffset > 0)
+    out.row--;
+  out.color = color;
+  out.width = width;
+  out.column = 0;
+
+  // rows below the bottom of the screen aren't decoded at all
+  uint8_t rows = (height + 7) / 8;
+  int8_t endPage = (CLIP_BOTTOM + 7) / 8;
+  if (out.row + rows > endPage)
+    rows = endPage - out.row;
+  out.rowsLeft = rows;
+
+  // Spans of pixels are assembled into bytes (vertical columns of 8 pixels).
+  // Whole bytes within a span are written all at once.
   uint8_t byte = 0x00;
-  uint8_t bit = 0x01;
-  while (rowOffset < rows) // + (frame*rows))
+  uint8_t bits = 0; // the number of bits of byte filled so far
+  while (true)
   {
-    uint16_t bitLength = 1;
-    while (cs.readBits(1) == 0)
-      bitLength += 2;
+    uint16_t len = cs.readSpanLength();
 
-    uint16_t len = cs.readBits(bitLength) + 1; // span length
-
-    // draw the span
-    for (uint16_t i = 0; i < len; ++i)
+    // finish a partly filled byte
+    if (bits != 0)
     {
+      uint8_t n = 8 - bits;
+      if (len < n)
+        n = len;
       if (spanColour != 0)
-        byte |= bit;
-      bit <<= 1;
+        byte |= (0xFF >> (8 - n)) << bits;
+      bits += n;
+      len -= n;
 
-      if (bit == 0) // reached end of byte
+      if (bits == 8)
       {
-        // draw
-        int bRow = startRow + rowOffset;
-
-        //if (byte) // possible optimisation
-        if ((bRow <= (HEIGHT / 8) - 1) && (bRow > -2) &&
-            (columnOffset + sx <= (WIDTH - 1)) && (columnOffset + sx >= 0))
-        {
-          int16_t offset = (bRow * WIDTH) + sx + columnOffset;
-          if (bRow >= 0)
-          {
-            int16_t index = offset;
-            uint8_t value = byte << yOffset;
-
-            if (color != 0)
-              sBuffer[index] |= value;
-            else
-              sBuffer[index] &= ~value;
-          }
-          if ((yOffset != 0) && (bRow < (HEIGHT / 8) - 1))
-          {
-            int16_t index = offset + WIDTH;
-            uint8_t value = byte >> (8 - yOffset);
-
-            if (color != 0)
-              sBuffer[index] |= value;
-            else
-              sBuffer[index] &= ~value;
-          }
-        }
-
-        // iterate
-        ++columnOffset;
-        if (columnOffset >= width)
-        {
-          columnOffset = 0;
-          ++rowOffset;
-        }
-
-        // reset byte
+        if (!out.write(byte, 1))
+          return;
         byte = 0x00;
-        bit = 0x01;
+        bits = 0;
       }
     }
 
+    if (len >= 8)
+    {
+      if (!out.write(spanColour != 0 ? 0xFF : 0x00, len / 8))
+        return;
+      len &= 7;
+    }
+
+    // start a new byte with what's left
+    if (len != 0)
+    {
+      byte = (spanColour != 0) ? (0xFF >> (8 - len)) : 0x00;
+      bits = len;
+    }
+
     spanColour ^= 0x01; // toggle colour bit (bit 0) for next span
   }
 }
@@ -1012,13 +2182,244 @@ void Arduboy2Base::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap,
 void Arduboy2Base::display()
 {
   paintScreen(sBuffer);
+
+  #ifdef DIRTY_TRACKING_MODE
+  clearDirty();
+  #endif
 }
 
 void Arduboy2Base::display(bool clear)
 {
   paintScreen(sBuffer, clear);
+
+  #ifdef DIRTY_TRACKING_MODE
+  // a cleared buffer no longer matches what's on the display
+  if (clear)
+    markDirty(0, 0, WIDTH, HEIGHT);
+  else
+    clearDirty();
+  #endif
 }
 
+void Arduboy2Base::displayChangedPages(bool clear)
+{
+  paintChangedPages(sBuffer, clear);
+
+  #ifdef DIRTY_TRACKING_MODE
+  if (clear)
+    markDirty(0, 0, WIDTH, HEIGHT);
+  else
+    clearDirty();
+  #endif
+}
+
+void Arduboy2Base::displayAsync(bool clear)
+{
+  waitDisplay();
+  memcpy(asyncBuffer, sBuffer, sizeof(asyncBuffer));
+  paintScreenAsync(asyncBuffer);
+
+  if (clear)
+    fillScreen(BLACK);
+  #ifdef DIRTY_TRACKING_MODE
+  else
+    clearDirty();
+  #endif
+}
+
+void Arduboy2Base::displayAsyncInPlace(bool clear)
+{
+  paintScreenAsync(sBuffer, clear);
+
+  #ifdef DIRTY_TRACKING_MODE
+  if (clear)
+    markDirty(0, 0, WIDTH, HEIGHT);
+  else
+    clearDirty();
+  #endif
+}
+
+void Arduboy2Base::displayDirty()
+{
+  if (dirtyStartX > dirtyEndX)
+    return;
+
+  paintRegion(sBuffer, dirtyStartX, dirtyStartPage, dirtyEndX, dirtyEndPage);
+  clearDirty();
+}
+
+void Arduboy2Base::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t xEnd = x + w - 1; // last x point
+  int16_t yEnd = y + h - 1; // last y point
+
+  // Clip to the display
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (xEnd > WIDTH - 1)
+    xEnd = WIDTH - 1;
+  if (yEnd > HEIGHT - 1)
+    yEnd = HEIGHT - 1;
+
+  if (x > xEnd || y > yEnd)
+    return;
+
+  // add to the existing area (an empty area always loses the comparisons)
+  if (x < dirtyStartX)
+    dirtyStartX = x;
+  if (xEnd > dirtyEndX)
+    dirtyEndX = xEnd;
+  if (y / 8 < dirtyStartPage)
+    dirtyStartPage = y / 8;
+  if (yEnd / 8 > dirtyEndPage)
+    dirtyEndPage = yEnd / 8;
+}
+
+void Arduboy2Base::clearDirty()
+{
+  dirtyStartX = 0xFF;
+  dirtyEndX = 0;
+  dirtyStartPage = 0xFF;
+  dirtyEndPage = 0;
+}
+
+void Arduboy2Base::scrollDisplay(int8_t lines)
+{
+  // The rows coming into view are the ones that were scrolled off the
+  // other edge, so they start at the old top row when moving up and just
+  // above it when moving down.
+  uint8_t count = lines < 0 ? -lines : lines;
+  uint8_t first = lines < 0 ? scrollLine - count : scrollLine;
+
+  if (count >= HEIGHT)
+  {
+    paintScreen(sBuffer);
+  }
+  else if (count != 0)
+  {
+    first &= HEIGHT - 1;
+    uint8_t page0 = first / 8;
+    uint8_t page1 = (first + count - 1) / 8;
+
+    // the rows may wrap from the bottom of the buffer to the top
+    if (page1 >= HEIGHT / 8)
+    {
+      paintRegion(sBuffer, 0, 0, WIDTH - 1, page1 - HEIGHT / 8);
+      page1 = HEIGHT / 8 - 1;
+    }
+    paintRegion(sBuffer, 0, page0, WIDTH - 1, page1);
+  }
+
+  scrollLine = (scrollLine + lines) & (HEIGHT - 1);
+  setStartLine(scrollLine);
+}
+
+uint8_t Arduboy2Base::getScrollLine()
+{
+  return scrollLine;
+}
+
+#ifdef CLIP_RECT_MODE
+void Arduboy2Base::setClipRect(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+  int16_t xEnd = x + w;
+  int16_t yEnd = y + h;
+
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (xEnd > WIDTH)
+    xEnd = WIDTH;
+  if (yEnd > HEIGHT)
+    yEnd = HEIGHT;
+
+  // An empty rectangle is stored with its left and top edges past its right
+  // and bottom edges, so the drawing functions' offscreen tests reject
+  // everything
+  if (x >= xEnd || y >= yEnd)
+  {
+    x = y = 0xFF;
+    xEnd = yEnd = 0;
+  }
+
+  clipLeft = x;
+  clipTop = y;
+  clipRight = xEnd;
+  clipBottom = yEnd;
+}
+
+void Arduboy2Base::resetClipRect()
+{
+  clipLeft = 0;
+  clipTop = 0;
+  clipRight = WIDTH;
+  clipBottom = HEIGHT;
+  clipDepth = 0;
+}
+
+bool Arduboy2Base::pushClipRect(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+  if (clipDepth == CLIP_STACK_DEPTH)
+    return false;
+
+  uint8_t *saved = clipStack[clipDepth++];
+  saved[0] = clipLeft;
+  saved[1] = clipTop;
+  saved[2] = clipRight;
+  saved[3] = clipBottom;
+
+  // intersect with the current rectangle
+  int16_t xEnd = x + w;
+  int16_t yEnd = y + h;
+
+  if (x < clipLeft)
+    x = clipLeft;
+  if (y < clipTop)
+    y = clipTop;
+  if (xEnd > clipRight)
+    xEnd = clipRight;
+  if (yEnd > clipBottom)
+    yEnd = clipBottom;
+
+  setClipRect(x, y, (x < xEnd) ? xEnd - x : 0, (y < yEnd) ? yEnd - y : 0);
+  return true;
+}
+
+void Arduboy2Base::popClipRect()
+{
+  if (clipDepth == 0)
+    return;
+
+  uint8_t *saved = clipStack[--clipDepth];
+  clipLeft = saved[0];
+  clipTop = saved[1];
+  clipRight = saved[2];
+  clipBottom = saved[3];
+}
+
+Rect Arduboy2Base::getClipRect()
+{
+  if (clipLeft >= clipRight)
+    return Rect(0, 0, 0, 0);
+  return Rect(clipLeft, clipTop, clipRight - clipLeft, clipBottom - clipTop);
+}
+
+uint8_t Arduboy2Base::clipPageMask(int16_t page)
+{
+  int16_t top = page * 8;
+  uint8_t mask = 0xFF;
+
+  if (clipTop > top)
+    mask = (clipTop - top >= 8) ? 0x00 : 0xFF << (clipTop - top);
+  if (clipBottom < top + 8)
+    mask &= (clipBottom <= top) ? 0x00 : 0xFF >> (top + 8 - clipBottom);
+  return mask;
+}
+#endif
+
 uint8_t* Arduboy2Base::getBuffer()
 {
   return sBuffer;
@@ -1064,6 +2465,141 @@ bool Arduboy2Base::collide(Rect rect1, Rect rect2)
            rect2.y + rect2.height <= rect1.y);
 }
 
+template<bool inProgmem>
+uint8_t Arduboy2Base::collideRects
+(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits)
+{
+  // the edges of the rectangle are only calculated once
+  const int16_t left = rect.x;
+  const int16_t top = rect.y;
+  const int16_t right = rect.x + rect.width;
+  const int16_t bottom = rect.y + rect.height;
+  uint8_t found = 0;
+
+  if (hits != NULL)
+    memset(hits, 0, (count + 7) / 8);
+
+  for (uint8_t i = 0; i < count; i++, rects++)
+  {
+    int16_t x, y;
+    uint8_t w, h;
+
+    // inProgmem is a constant, so only one of the reads is compiled
+    if (inProgmem)
+    {
+      x = pgm_read_word(&rects->x);
+      y = pgm_read_word(&rects->y);
+      w = pgm_read_byte(&rects->width);
+      h = pgm_read_byte(&rects->height);
+    }
+    else
+    {
+      x = rects->x;
+      y = rects->y;
+      w = rects->width;
+      h = rects->height;
+    }
+
+    // the same test as collide(Rect, Rect)
+    if (x >= right || x + w <= left || y >= bottom || y + h <= top)
+      continue;
+
+    if (hits == NULL)
+      return i;
+
+    hits[i / 8] |= 1 << (i % 8);
+    found++;
+  }
+
+  return (hits == NULL) ? count : found;
+}
+
+template<bool inProgmem>
+uint8_t Arduboy2Base::collidePoints
+(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits)
+{
+  const int16_t left = rect.x;
+  const int16_t top = rect.y;
+  const int16_t right = rect.x + rect.width;
+  const int16_t bottom = rect.y + rect.height;
+  uint8_t found = 0;
+
+  if (hits != NULL)
+    memset(hits, 0, (count + 7) / 8);
+
+  for (uint8_t i = 0; i < count; i++, points++)
+  {
+    int16_t x, y;
+
+    if (inProgmem)
+    {
+      x = pgm_read_word(&points->x);
+      y = pgm_read_word(&points->y);
+    }
+    else
+    {
+      x = points->x;
+      y = points->y;
+    }
+
+    // the same test as collide(Point, Rect)
+    if (x < left || x >= right || y < top || y >= bottom)
+      continue;
+
+    if (hits == NULL)
+      return i;
+
+    hits[i / 8] |= 1 << (i % 8);
+    found++;
+  }
+
+  return (hits == NULL) ? count : found;
+}
+
+int16_t Arduboy2Base::collideAny(const Rect &rect, const Rect *rects, uint8_t count)
+{
+  uint8_t i = collideRects<false>(rect, rects, count, NULL);
+  return (i < count) ? i : -1;
+}
+
+int16_t Arduboy2Base::collideAny(const Rect &rect, const Point *points, uint8_t count)
+{
+  uint8_t i = collidePoints<false>(rect, points, count, NULL);
+  return (i < count) ? i : -1;
+}
+
+int16_t Arduboy2Base::collideAny_P(const Rect &rect, const Rect *rects, uint8_t count)
+{
+  uint8_t i = collideRects<true>(rect, rects, count, NULL);
+  return (i < count) ? i : -1;
+}
+
+int16_t Arduboy2Base::collideAny_P(const Rect &rect, const Point *points, uint8_t count)
+{
+  uint8_t i = collidePoints<true>(rect, points, count, NULL);
+  return (i < count) ? i : -1;
+}
+
+uint8_t Arduboy2Base::collideAll(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits)
+{
+  return collideRects<false>(rect, rects, count, hits);
+}
+
+uint8_t Arduboy2Base::collideAll(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits)
+{
+  return collidePoints<false>(rect, points, count, hits);
+}
+
+uint8_t Arduboy2Base::collideAll_P(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits)
+{
+  return collideRects<true>(rect, rects, count, hits);
+}
+
+uint8_t Arduboy2Base::collideAll_P(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits)
+{
+  return collidePoints<true>(rect, points, count, hits);
+}
+
 uint16_t Arduboy2Base::readUnitID()
 {
   return EEPROM.read(EEPROM_UNIT_ID) |
@@ -1281,15 +2817,79 @@ void Arduboy2::drawChar
   bool draw_background = bg != color;
   const unsigned char* bitmap = font + c * 5;
 
-  if ((x >= WIDTH) ||              // Clip right
-      (y >= HEIGHT) ||             // Clip bottom
-      ((x + 5 * size - 1) < 0) ||  // Clip left
-      ((y + 8 * size - 1) < 0)     // Clip top
+  if ((x >= CLIP_RIGHT) ||                // Clip right
+      (y >= CLIP_BOTTOM) ||               // Clip bottom
+      ((x + 6 * size - 1) < CLIP_LEFT) || // Clip left
+      ((y + 8 * size - 1) < CLIP_TOP)     // Clip top
      )
   {
     return;
   }
 
+  if (size == 1 || size == 2 || size == 4)
+  {
+    // Each column of the character is one byte, or 2 or 4 bytes when it's
+    // scaled up, so each byte is written to the one or two pages it covers
+    // as a whole. As with drawPixel(), a color with bit 0 clear draws
+    // black, and black pixels are only drawn when the background is drawn
+    // or black was asked for as a background.
+    bool fgSet = color & 0x01;
+    bool fgClear = !fgSet && (color != BLACK || draw_background);
+    bool bgSet = bg & 0x01;
+    bool bgClear = !bgSet && (bg != BLACK || draw_background);
+    uint8_t shift = size >> 1; // 0, 1 or 2
+
+    int16_t page = y / 8;
+    uint8_t yOffset = y & 7;
+    if (y < 0 && yOffset > 0)
+      page--;
+
+    int16_t iStart = (x < CLIP_LEFT) ? CLIP_LEFT - x : 0;
+    int16_t iEnd = (x + 6 * size > CLIP_RIGHT) ? CLIP_RIGHT - x : 6 * size;
+
+    #ifdef DIRTY_TRACKING_MODE
+    markDirty(x, y, 6 * size, 8 * size);
+    #endif
+
+    for (uint8_t part = 0; part < size; part++, page++)
+    {
+      // the rows of the two pages that can be drawn on
+      uint16_t rowMask = drawablePageRows(page) |
+                         (drawablePageRows(page + 1) << 8);
+      if (rowMask == 0)
+        continue;
+
+      uint8_t *p = sBuffer + (page * WIDTH) + x;
+      uint8_t setBits = 0;
+      uint8_t clearBits = 0;
+
+      for (int16_t i = iStart; i < iEnd; i++)
+      {
+        // a new column of the font
+        if (i == iStart || (i & (size - 1)) == 0)
+        {
+          uint8_t c = i >> shift;
+          line = (c < 5) ? pgm_read_byte(bitmap + c) : 0x00;
+          if (shift != 0)
+            line = scaleBits(line, shift, part);
+
+          setBits = (fgSet ? line : 0) | (bgSet ? ~line : 0);
+          clearBits = (fgClear ? line : 0) | (bgClear ? ~line : 0);
+        }
+
+        uint16_t set16 = (setBits << yOffset) & rowMask;
+        uint16_t clear16 = (clearBits << yOffset) & rowMask;
+
+        if ((uint8_t)(set16 | clear16) != 0)
+          p[i] = (p[i] & ~(uint8_t)clear16) | (uint8_t)set16;
+        if ((set16 | clear16) >> 8 != 0)
+          p[i + WIDTH] = (p[i + WIDTH] & ~(uint8_t)(clear16 >> 8)) |
+                         (uint8_t)(set16 >> 8);
+      }
+    }
+    return;
+  }
+
   for (uint8_t i = 0; i < 6; i++ )
   {
     line = pgm_read_byte(bitmap++);
@@ -1302,11 +2902,10 @@ void Arduboy2::drawChar
       uint8_t draw_color = (line & 0x1) ? color : bg;
 
       if (draw_color || draw_background) {
-        for (uint8_t a = 0; a < size; a++ ) {
-          for (uint8_t b = 0; b < size; b++ ) {
-            drawPixel(x + (i * size) + a, y + (j * size) + b, draw_color);
-          }
-        }
+        // each pixel of the font is a block of the text size, clipped as
+        // one rectangle (drawn as by drawPixel(), so INVERT draws black)
+        fillRect(x + (i * size), y + (j * size), size, size,
+                 (draw_color & 0x01) ? WHITE : BLACK);
       }
       line >>= 1;
     }
@@ -71,6 +71,34 @@
 // Pixels that would exceed the display limits will be ignored.
 #define PIXEL_SAFE_MODE
 
+// If defined, the drawing functions record the area of the screen buffer
+// that they change, so displayDirty() can send only that area to the display.
+// This adds some code and time to every drawing function, so it isn't defined
+// by default. Without it, markDirty() can be used to record changed areas.
+// #define DIRTY_TRACKING_MODE
+
+// If defined, the drawing functions only change pixels inside a clip
+// rectangle, set using setClipRect() or pushClipRect(). This adds some code
+// and time to the drawing functions, so it isn't defined by default.
+// #define CLIP_RECT_MODE
+
+#ifdef CLIP_RECT_MODE
+// The number of clip rectangles that pushClipRect() can save
+#define CLIP_STACK_DEPTH 4
+
+// The area of the screen that can be drawn on. The right and bottom
+// edges are exclusive.
+#define CLIP_LEFT (Arduboy2Base::clipLeft)
+#define CLIP_TOP (Arduboy2Base::clipTop)
+#define CLIP_RIGHT (Arduboy2Base::clipRight)
+#define CLIP_BOTTOM (Arduboy2Base::clipBottom)
+#else
+#define CLIP_LEFT 0
+#define CLIP_TOP 0
+#define CLIP_RIGHT WIDTH
+#define CLIP_BOTTOM HEIGHT
+#endif
+
 // pixel colors
 #define BLACK 0  /**< Color value for an unlit pixel for draw functions. */
 #define WHITE 1  /**< Color value for a lit pixel for draw functions. */
@@ -81,7 +109,8 @@
  * BLACK pixels will become WHITE and WHITE will become BLACK.
  *
  * \note
- * Only function Arduboy2Base::drawBitmap() currently supports this value.
+ * Only functions Arduboy2Base::drawBitmap() and Arduboy2Base::fillRect()
+ * currently support this value.
  */
 #define INVERT 2
 
@@ -472,6 +501,319 @@ class Arduboy2Base : public Arduboy2Core
    */
   void display(bool clear);
 
+  /** \brief
+   * Copy only the changed pages of the display buffer to the display. The
+   * display buffer can optionally be cleared.
+   *
+   * \param clear If `true` the display buffer will be cleared to zero.
+   * The defined value `CLEAR_BUFFER` should be used instead of `true` to make
+   * it more meaningful. (optional; defaults to `false`)
+   *
+   * \details
+   * This can be used in place of `display()`. Each page (8 pixel high row)
+   * of the display buffer is compared, using a checksum, to what it held when
+   * it was last sent by this function. Only the pages that are different are
+   * sent to the display.
+   *
+   * This saves time for sketches where most of the screen stays the same
+   * from frame to frame. `pagesSkipped()` returns the number of pages that
+   * weren't sent by the last call.
+   *
+   * \note
+   * If `display()` or any other function that writes to the display is used
+   * in between calls to this function, `resetPageChecksums()` must be called
+   * before calling this function again.
+   *
+   * \see display() Arduboy2Core::paintChangedPages() pagesSkipped()
+   */
+  void displayChangedPages(bool clear = false);
+
+  /** \brief
+   * Start copying the display buffer to the display in the background.
+   * The display buffer can optionally be cleared.
+   *
+   * \param clear If `true` the display buffer will be cleared to zero.
+   * The defined value `CLEAR_BUFFER` should be used instead of `true` to make
+   * it more meaningful. (optional; defaults to `false`)
+   *
+   * \details
+   * The display buffer is copied to a second 1024 byte buffer, which is then
+   * sent to the display by `paintScreenAsync()` while the sketch continues.
+   * Drawing of the next frame can start as soon as this function returns.
+   * If the previous frame is still being sent, this function waits for it
+   * to finish first.
+   *
+   * The second buffer is only included in sketches that use this function.
+   * For sketches that can't spare the RAM, `displayAsyncInPlace()` sends the
+   * display buffer itself.
+   *
+   * \note
+   * The `ARDUBOY_ASYNC_DISPLAY` macro must be included in the sketch to use
+   * this function. Call `waitDisplay()` before using any other function that
+   * writes to the display, such as `display()`.
+   *
+   * \see ARDUBOY_ASYNC_DISPLAY displayAsyncInPlace()
+   * Arduboy2Core::paintScreenAsync() display()
+   */
+  void displayAsync(bool clear = false);
+
+  /** \brief
+   * Start sending the display buffer to the display in the background,
+   * without using a second buffer. The display buffer can optionally be
+   * cleared.
+   *
+   * \param clear If `true` the display buffer will be cleared to zero.
+   * The defined value `CLEAR_BUFFER` should be used instead of `true` to make
+   * it more meaningful. (optional; defaults to `false`)
+   *
+   * \details
+   * The display buffer is sent directly, one page (8 pixel high row) at a
+   * time, by `paintScreenAsync()`. No extra RAM is needed but nothing may be
+   * drawn until the transfer is complete, so the sketch should only do work
+   * that doesn't draw, such as reading buttons and moving objects, before
+   * calling `waitDisplay()`.
+   *
+   * \note
+   * The `ARDUBOY_ASYNC_DISPLAY` macro must be included in the sketch to use
+   * this function.
+   *
+   * \see ARDUBOY_ASYNC_DISPLAY displayAsync() Arduboy2Core::waitDisplay()
+   */
+  void displayAsyncInPlace(bool clear = false);
+
+  /** \brief
+   * Copy only the changed area of the display buffer to the display.
+   *
+   * \details
+   * The part of the display buffer that has been recorded as changed, since
+   * the previous call to this function or `display()`, is copied to the
+   * display. The area is rounded out to whole pages (8 pixel high rows) and
+   * sent as one rectangle covering all the changes. If nothing has changed,
+   * nothing is sent.
+   *
+   * When only a small part of the screen changes each frame, such as a score
+   * or a moving cursor, this takes much less time than `display()`.
+   *
+   * If `DIRTY_TRACKING_MODE` is defined in Arduboy2.h, all the drawing
+   * functions record the areas they change. Otherwise, the sketch must call
+   * `markDirty()` for the areas it has changed.
+   *
+   * \note
+   * Clearing the buffer with `clear()`, `fillScreen()` or
+   * `display(CLEAR_BUFFER)` marks the entire screen as changed, so a sketch
+   * using this function should instead erase only the areas it has drawn on.
+   *
+   * \see markDirty() display() paintRegion()
+   */
+  void displayDirty();
+
+  /** \brief
+   * Record an area of the display buffer as having been changed.
+   *
+   * \param x The X coordinate of the upper left corner.
+   * \param y The Y coordinate of the upper left corner.
+   * \param w The width of the area.
+   * \param h The height of the area.
+   *
+   * \details
+   * The given rectangle, clipped to the screen, is added to the area that
+   * `displayDirty()` will send to the display.
+   *
+   * If `DIRTY_TRACKING_MODE` is defined in Arduboy2.h the drawing functions
+   * call this themselves, so a sketch only needs to use it after writing to
+   * the display buffer directly.
+   *
+   * \see displayDirty()
+   */
+  static void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  /** \brief
+   * Scroll the display vertically in hardware, sending only the rows of the
+   * display buffer that come into view.
+   *
+   * \param lines The number of rows to scroll by. A positive value moves the
+   * image up, bringing new rows in at the bottom. A negative value moves the
+   * image down, bringing new rows in at the top.
+   *
+   * \details
+   * The display's start line is moved using `setStartLine()`, so the image
+   * already on the display moves without being sent again. Only the pages
+   * (8 pixel high rows) of the display buffer containing the rows that come
+   * into view are sent, before the display is moved.
+   *
+   * When using this function the display buffer holds the display's RAM,
+   * which wraps around vertically, rather than the screen as it is seen.
+   * Screen row `r` shows display buffer row
+   * `(r + getScrollLine()) % HEIGHT`. Before calling this function, the
+   * sketch should draw the new rows at the buffer rows they will occupy:
+   *
+   * \code{.cpp}
+   * // a vertical shooter, with the playfield moving down by 1 row
+   * uint8_t newRow = (arduboy.getScrollLine() - 1) & (HEIGHT - 1);
+   * arduboy.drawFastHLine(0, newRow, WIDTH, BLACK);
+   * // ... draw the new top row of the playfield at y = newRow ...
+   * arduboy.scrollDisplay(-1);
+   * \endcode
+   *
+   * Calling `display()` sends the entire buffer, at its current scroll
+   * position.
+   *
+   * \see getScrollLine() Arduboy2Core::setStartLine()
+   */
+  void scrollDisplay(int8_t lines);
+
+  /** \brief
+   * Get the display buffer row currently shown at the top of the screen.
+   *
+   * \return The display buffer row (0 to HEIGHT - 1) shown at the top of the
+   * screen.
+   *
+   * \details
+   * The value starts at 0 and is changed by `scrollDisplay()`.
+   *
+   * \see scrollDisplay()
+   */
+  static uint8_t getScrollLine();
+
+#ifdef CLIP_RECT_MODE
+  /** \brief
+   * Limit drawing to a rectangle of the screen.
+   *
+   * \param x The X coordinate of the upper left corner.
+   * \param y The Y coordinate of the upper left corner.
+   * \param w The width of the rectangle.
+   * \param h The height of the rectangle.
+   *
+   * \details
+   * After this call, the drawing functions only change pixels inside the
+   * given rectangle, clipped to the screen. This includes the sprite and
+   * text functions. A drawing call that is entirely outside the rectangle
+   * returns without changing anything.
+   *
+   * The current clip rectangle is replaced. Rectangles saved by
+   * `pushClipRect()` aren't affected.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h. The functions that clear or fill the whole screen, such as
+   * `clear()`, `fillScreen()` and `display(CLEAR_BUFFER)`, aren't limited by
+   * the clip rectangle.
+   *
+   * \see resetClipRect() pushClipRect() getClipRect()
+   */
+  static void setClipRect(int16_t x, int16_t y, uint8_t w, uint8_t h);
+
+  /** \brief
+   * Allow drawing on the whole screen again.
+   *
+   * \details
+   * The clip rectangle is set to the whole screen and any rectangles saved
+   * by `pushClipRect()` are discarded.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h.
+   *
+   * \see setClipRect() pushClipRect()
+   */
+  static void resetClipRect();
+
+  /** \brief
+   * Save the current clip rectangle and limit drawing to a part of it.
+   *
+   * \param x The X coordinate of the upper left corner.
+   * \param y The Y coordinate of the upper left corner.
+   * \param w The width of the rectangle.
+   * \param h The height of the rectangle.
+   *
+   * \return `true` if the clip rectangle was changed. `false` if
+   * `CLIP_STACK_DEPTH` rectangles have already been saved, in which case
+   * nothing is changed.
+   *
+   * \details
+   * The current clip rectangle is saved and the new one is set to the part
+   * of it that is inside the given rectangle, so drawing is never allowed
+   * outside an enclosing viewport. `popClipRect()` restores the saved
+   * rectangle. Calls can be nested up to `CLIP_STACK_DEPTH` deep.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h.
+   *
+   * \see popClipRect() setClipRect()
+   */
+  static bool pushClipRect(int16_t x, int16_t y, uint8_t w, uint8_t h);
+
+  /** \brief
+   * Restore the clip rectangle saved by the last `pushClipRect()`.
+   *
+   * \details
+   * If no rectangle has been saved, nothing is changed.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h.
+   *
+   * \see pushClipRect()
+   */
+  static void popClipRect();
+
+  /** \brief
+   * Get the current clip rectangle.
+   *
+   * \return The area of the screen that drawing is limited to. If nothing
+   * can be drawn, the width and height are 0.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h.
+   *
+   * \see setClipRect() pushClipRect()
+   */
+  static Rect getClipRect();
+
+  /** \brief
+   * Get the pixels of a page of the display buffer that are inside the clip
+   * rectangle.
+   *
+   * \param page The page (8 pixel high row) of the display buffer. Pages
+   * above or below the screen give 0.
+   *
+   * \return A byte with a bit set for each pixel row of the page that is
+   * inside the clip rectangle vertically.
+   *
+   * \details
+   * This is used by the functions that write whole bytes to the display
+   * buffer. A sketch that writes to `sBuffer` directly can use it in the
+   * same way, along with the `CLIP_LEFT` and `CLIP_RIGHT` columns.
+   *
+   * \note
+   * This function is only available if `CLIP_RECT_MODE` is defined in
+   * Arduboy2.h.
+   */
+  static uint8_t clipPageMask(int16_t page);
+
+  /** \brief
+   * The edges of the clip rectangle.
+   *
+   * \details
+   * Drawing is limited to columns `clipLeft` to `clipRight - 1` and rows
+   * `clipTop` to `clipBottom - 1`. An empty clip rectangle has `clipLeft`
+   * and `clipTop` set to 255 and `clipRight` and `clipBottom` set to 0.
+   * These are public so the drawing functions of other classes
+   * can read them quickly, but they should only be changed using
+   * `setClipRect()`, `pushClipRect()`, `popClipRect()` or
+   * `resetClipRect()`.
+   *
+   * \note
+   * These are only available if `CLIP_RECT_MODE` is defined in Arduboy2.h.
+   */
+  static uint8_t clipLeft;
+  static uint8_t clipTop;    /**< \see clipLeft */
+  static uint8_t clipRight;  /**< \see clipLeft */
+  static uint8_t clipBottom; /**< \see clipLeft */
+#endif
+
   /** \brief
    * Set a single pixel in the display buffer to the specified color.
    *
@@ -520,22 +862,44 @@ class Arduboy2Base : public Arduboy2Core
    */
   void fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a filled-in circle of a given radius, using a fill pattern.
+   *
+   * \param x0 The X coordinate of the circle's center.
+   * \param y0 The Y coordinate of the circle's center.
+   * \param r The radius of the circle in pixels.
+   * \param pattern A pointer to an 8 byte fill pattern in program memory.
+   * \param color The circle's color (optional; defaults to WHITE).
+   *
+   * \details
+   * Only the pixels of the circle that are set in the pattern are drawn.
+   * See `fillRectPattern()` for the format of the pattern.
+   *
+   * \see fillRectPattern() ditherPattern() fillCircle()
+   */
+  void fillCirclePattern(int16_t x0, int16_t y0, uint8_t r, const uint8_t *pattern, uint8_t color = WHITE);
+
   // Draw one or both vertical halves of a filled-in circle or
   // rounded rectangle edge.
   // (Not officially part of the API)
-  void fillCircleHelper(int16_t x0, int16_t y0, uint8_t r, uint8_t sides, int16_t delta, uint8_t color = WHITE);
+  void fillCircleHelper(int16_t x0, int16_t y0, uint8_t r, uint8_t sides, int16_t delta, uint8_t color = WHITE, const uint8_t *pattern = NULL);
 
   /** \brief
    * Draw a line between two specified points.
    *
    * \param x0,x1 The X coordinates of the line ends.
    * \param y0,y1 The Y coordinates of the line ends.
-   * \param color The line's color (optional; defaults to WHITE).
+   * \param color The line's color. If the value is INVERT, all pixels of
+   *              the line will be inverted. (optional; defaults to WHITE).
    *
    * \details
    * Draw a line from the start point to the end point using
    * Bresenham's algorithm.
    * The start and end points can be at any location with respect to the other.
+   *
+   * The line is clipped to the display before drawing, without changing
+   * which of its pixels are drawn. Horizontal and vertical lines are drawn
+   * using `drawFastHLine()` and `drawFastVLine()`.
    */
   void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color = WHITE);
 
@@ -556,7 +920,14 @@ class Arduboy2Base : public Arduboy2Core
    * \param x The X coordinate of the upper start point.
    * \param y The Y coordinate of the upper start point.
    * \param h The height of the line.
-   * \param color The color of the line (optional; defaults to WHITE).
+   * \param color The color of the line. If the value is INVERT, all
+   *              pixels of the line will be inverted.
+   *              (optional; defaults to WHITE).
+   *
+   * \details
+   * The line is clipped to the display once and then written a byte at a
+   * time, with a whole byte for each page (8 pixel high row) that it
+   * completely covers.
    */
   void drawFastVLine(int16_t x, int16_t y, uint8_t h, uint8_t color = WHITE);
 
@@ -566,7 +937,9 @@ class Arduboy2Base : public Arduboy2Core
    * \param x The X coordinate of the left start point.
    * \param y The Y coordinate of the left start point.
    * \param w The width of the line.
-   * \param color The color of the line (optional; defaults to WHITE).
+   * \param color The color of the line. If the value is INVERT, all
+   *              pixels of the line will be inverted.
+   *              (optional; defaults to WHITE).
    */
   void drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color = WHITE);
 
@@ -577,10 +950,49 @@ class Arduboy2Base : public Arduboy2Core
    * \param y The Y coordinate of the upper left corner.
    * \param w The width of the rectangle.
    * \param h The height of the rectangle.
-   * \param color The color of the pixel (optional; defaults to WHITE).
+   * \param color The color of the rectangle. If the value is INVERT, all
+   *              pixels within the rectangle will be inverted.
+   *              (optional; defaults to WHITE).
+   *
+   * \details
+   * The rectangle is clipped to the display once and then written a whole
+   * byte (8 vertical pixels) at a time, so it's considerably faster than
+   * drawing it one line or pixel at a time.
    */
   void fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a filled-in rectangle of a specified width and height, using a
+   * fill pattern.
+   *
+   * \param x The X coordinate of the upper left corner.
+   * \param y The Y coordinate of the upper left corner.
+   * \param w The width of the rectangle.
+   * \param h The height of the rectangle.
+   * \param pattern A pointer to an 8 byte fill pattern in program memory.
+   * \param color The color of the rectangle. If the value is INVERT, the
+   *              pixels set in the pattern will be inverted.
+   *              (optional; defaults to WHITE).
+   *
+   * \details
+   * Only the pixels of the rectangle that are set in the pattern are drawn
+   * in the given color. The others are left unchanged. This can be used to
+   * draw shaded areas, or to fade parts of the screen using BLACK.
+   *
+   * The pattern is 8 pixels wide and 8 pixels high and is repeated across
+   * the screen, lined up with the screen's top left corner, so areas drawn
+   * with the same pattern join up smoothly. It has the same format as the
+   * screen buffer: each byte is a column of 8 vertical pixels, with the
+   * least significant bit at the top. The first byte is used for columns
+   * 0, 8, 16, etc. `ditherPattern()` provides a range of shading patterns.
+   *
+   * The pattern is applied as each byte of the rectangle is written, so this
+   * takes little more time than `fillRect()`.
+   *
+   * \see ditherPattern() fillRect() fillScreenPattern()
+   */
+  void fillRectPattern(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *pattern, uint8_t color = WHITE);
+
   /** \brief
    * Fill the screen buffer with the specified color.
    *
@@ -588,6 +1000,45 @@ class Arduboy2Base : public Arduboy2Core
    */
   void fillScreen(uint8_t color = WHITE);
 
+  /** \brief
+   * Fill the screen buffer using a fill pattern.
+   *
+   * \param pattern A pointer to an 8 byte fill pattern in program memory.
+   * \param color The fill color (optional; defaults to WHITE).
+   *
+   * \details
+   * The pixels set in the pattern are set to the given color. The others
+   * are left unchanged. See `fillRectPattern()` for the format of the
+   * pattern.
+   *
+   * \see fillRectPattern() ditherPattern() fillScreen()
+   */
+  void fillScreenPattern(const uint8_t *pattern, uint8_t color = WHITE);
+
+  /** \brief
+   * Get one of a range of ordered dither patterns, for use as a fill
+   * pattern.
+   *
+   * \param level The number of pixels in each 4x4 area to set, from 0 (none)
+   * to 16 (all). Values above 16 are treated as 16.
+   *
+   * \return A pointer to the 8 byte pattern in program memory.
+   *
+   * \details
+   * The patterns come from a 4x4 Bayer matrix, tiled to fill the 8x8 pattern,
+   * which spreads the set pixels evenly to give the appearance of a shade of
+   * gray. Each level adds pixels to the previous one, so stepping through
+   * the levels gives a smooth fade.
+   *
+   * \code{.cpp}
+   * // a 50% gray box
+   * arduboy.fillRectPattern(10, 10, 40, 20, arduboy.ditherPattern(8));
+   * \endcode
+   *
+   * \see fillRectPattern()
+   */
+  static const uint8_t *ditherPattern(uint8_t level);
+
   /** \brief
    * Draw a rectangle with rounded corners.
    *
@@ -612,6 +1063,25 @@ class Arduboy2Base : public Arduboy2Core
    */
   void fillRoundRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a filled-in rectangle with rounded corners, using a fill pattern.
+   *
+   * \param x The X coordinate of the left edge.
+   * \param y The Y coordinate of the top edge.
+   * \param w The width of the rectangle.
+   * \param h The height of the rectangle.
+   * \param r The radius of the semicircles forming the corners.
+   * \param pattern A pointer to an 8 byte fill pattern in program memory.
+   * \param color The color of the rectangle (optional; defaults to WHITE).
+   *
+   * \details
+   * Only the pixels of the rectangle that are set in the pattern are drawn.
+   * See `fillRectPattern()` for the format of the pattern.
+   *
+   * \see fillRectPattern() ditherPattern() fillRoundRect()
+   */
+  void fillRoundRectPattern(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t r, const uint8_t *pattern, uint8_t color = WHITE);
+
   /** \brief
    * Draw a triangle given the coordinates of each corner.
    *
@@ -630,14 +1100,151 @@ class Arduboy2Base : public Arduboy2Core
    *
    * \param x0,x1,x2 The X coordinates of the corners.
    * \param y0,y1,y2 The Y coordinates of the corners.
-   * \param color The triangle's color (optional; defaults to WHITE).
+   * \param color The triangle's color. If the value is INVERT, all pixels
+   *              within the triangle will be inverted.
+   *              (optional; defaults to WHITE).
    *
    * \details
    * A triangle is drawn by specifying each of the three corner locations.
    * The corners can be at any position with respect to the others.
+   *
+   * The triangle is filled one column at a time, so each byte of the
+   * display buffer is written only once. Columns off the display are
+   * skipped.
    */
   void fillTriangle (int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a filled-in triangle given the coordinates of each corner, using a
+   * fill pattern.
+   *
+   * \param x0,x1,x2 The X coordinates of the corners.
+   * \param y0,y1,y2 The Y coordinates of the corners.
+   * \param pattern A pointer to an 8 byte fill pattern in program memory.
+   * \param color The triangle's color (optional; defaults to WHITE).
+   *
+   * \details
+   * Only the pixels of the triangle that are set in the pattern are drawn.
+   * See `fillRectPattern()` for the format of the pattern.
+   *
+   * \see fillRectPattern() ditherPattern() fillTriangle()
+   */
+  void fillTrianglePattern(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const uint8_t *pattern, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw the outline of a polygon, given an array of its corner points in
+   * RAM.
+   *
+   * \param points An array of the polygon's corner points, in order around
+   *               the outline.
+   * \param count The number of points in the array.
+   * \param color The outline's color (optional; defaults to WHITE).
+   *
+   * \details
+   * A line is drawn from each point to the next, and from the last point
+   * back to the first.
+   *
+   * \see drawPolygon_P() fillPolygon() Point
+   */
+  void drawPolygon(const Point *points, uint8_t count, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw the outline of a polygon, given an array of its corner points in
+   * program memory.
+   *
+   * \param points An array in program memory of the polygon's corner
+   *               points, in order around the outline.
+   * \param count The number of points in the array.
+   * \param color The outline's color (optional; defaults to WHITE).
+   *
+   * \details
+   * This is the same as `drawPolygon()` except that the array is located in
+   * program memory.
+   *
+   * \see drawPolygon()
+   */
+  void drawPolygon_P(const Point *points, uint8_t count, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a filled-in polygon, given an array of its corner points in RAM.
+   *
+   * \param points An array of the polygon's corner points, in order around
+   *               the outline.
+   * \param count The number of points in the array.
+   * \param color The polygon's color. If the value is INVERT, all pixels
+   *              within the polygon will be inverted.
+   *              (optional; defaults to WHITE).
+   *
+   * \details
+   * The polygon can be any shape, including concave and self-intersecting
+   * shapes. Areas enclosed an odd number of times by the outline are filled.
+   *
+   * The polygon is filled one column at a time, keeping a table of the
+   * edges that cross the current column. Each byte of the display buffer is
+   * written only once, so it's faster and smaller than splitting the polygon
+   * into triangles. Up to 8 edges crossing the same column are handled.
+   *
+   * For a convex polygon, `fillConvexPolygon()` is faster.
+   *
+   * \see fillPolygon_P() fillConvexPolygon() drawPolygon() Point
+   */
+  void fillPolygon(const Point *points, uint8_t count, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a filled-in polygon, given an array of its corner points in
+   * program memory.
+   *
+   * \param points An array in program memory of the polygon's corner
+   *               points, in order around the outline.
+   * \param count The number of points in the array.
+   * \param color The polygon's color (optional; defaults to WHITE).
+   *
+   * \details
+   * This is the same as `fillPolygon()` except that the array is located in
+   * program memory.
+   *
+   * \see fillPolygon()
+   */
+  void fillPolygon_P(const Point *points, uint8_t count, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a filled-in convex polygon, given an array of its corner points in
+   * RAM.
+   *
+   * \param points An array of the polygon's corner points, in order around
+   *               the outline.
+   * \param count The number of points in the array.
+   * \param color The polygon's color. If the value is INVERT, all pixels
+   *              within the polygon will be inverted.
+   *              (optional; defaults to WHITE).
+   *
+   * \details
+   * The polygon must be convex, meaning that no vertical line crosses its
+   * outline more than twice. Each column is filled between the two halves of
+   * the outline running from the leftmost point to the rightmost, so no
+   * table of edges or sorting is needed.
+   *
+   * \see fillConvexPolygon_P() fillPolygon() fillTriangle() Point
+   */
+  void fillConvexPolygon(const Point *points, uint8_t count, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a filled-in convex polygon, given an array of its corner points in
+   * program memory.
+   *
+   * \param points An array in program memory of the polygon's corner
+   *               points, in order around the outline.
+   * \param count The number of points in the array.
+   * \param color The polygon's color (optional; defaults to WHITE).
+   *
+   * \details
+   * This is the same as `fillConvexPolygon()` except that the array is
+   * located in program memory.
+   *
+   * \see fillConvexPolygon()
+   */
+  void fillConvexPolygon_P(const Point *points, uint8_t count, uint8_t color = WHITE);
+
   /** \brief
    * Draw a bitmap from an array in program memory.
    *
@@ -662,6 +1269,60 @@ class Arduboy2Base : public Arduboy2Core
    */
   static void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a bitmap from an array in RAM.
+   *
+   * \param x The X coordinate of the top left pixel affected by the bitmap.
+   * \param y The Y coordinate of the top left pixel affected by the bitmap.
+   * \param bitmap A pointer to the bitmap array in RAM.
+   * \param w The width of the bitmap in pixels.
+   * \param h The height of the bitmap in pixels.
+   * \param color The color of pixels for bits set to 1 in the bitmap.
+   *              If the value is INVERT, bits set to 1 will invert the
+   *              corresponding pixel. (optional; defaults to WHITE).
+   *
+   * \details
+   * This is the same as `drawBitmap()` except that the array is in RAM, so
+   * it can be a bitmap that's built or changed while the sketch is running.
+   *
+   * \see drawBitmap() Sprites::drawSelfMaskedRAM()
+   */
+  static void drawBitmapRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a bitmap from an array in program memory, scaled up 2 or 4 times.
+   *
+   * \param x The X coordinate of the top left pixel affected by the bitmap.
+   * \param y The Y coordinate of the top left pixel affected by the bitmap.
+   * \param bitmap A pointer to the bitmap array in program memory.
+   * \param w The width of the bitmap in pixels, before scaling.
+   * \param h The height of the bitmap in pixels, before scaling.
+   * \param scale The number of times to scale up the bitmap: 2 or 4.
+   *              Any other value draws it unscaled, using `drawBitmap()`.
+   * \param color The color of pixels for bits set to 1 in the bitmap.
+   *              If the value is INVERT, bits set to 1 will invert the
+   *              corresponding pixel. (optional; defaults to WHITE).
+   *
+   * \details
+   * This is the same as `drawBitmap()` except that each pixel of the bitmap
+   * is drawn as a square block of `scale` by `scale` pixels. The bitmap
+   * array is in the same format.
+   *
+   * Each byte of the array is expanded into 2 or 4 bytes using a lookup
+   * table, and each of those is written to the display buffer as a whole,
+   * so this is much faster than drawing a rectangle for each pixel.
+   *
+   * \see drawBitmap() Sprites::drawScaled()
+   */
+  static void drawBitmapScaled(int16_t x, int16_t y, const uint8_t *bitmap,
+                               uint8_t w, uint8_t h, uint8_t scale,
+                               uint8_t color = WHITE);
+
+  // Get one of the bytes that a column byte becomes when it's scaled up 2
+  // (shift = 1) or 4 (shift = 2) times. Part 0 is the top byte.
+  // (Not officially part of the API)
+  static uint8_t scaleBits(uint8_t bits, uint8_t shift, uint8_t part);
+
   /** \brief
    * Draw a bitmap from a horizontally oriented array in program memory.
    *
@@ -1080,6 +1741,183 @@ class Arduboy2Base : public Arduboy2Core
    */
   static bool collide(Rect rect1, Rect rect2);
 
+  /** \brief
+   * Find the first rectangle in an array that a rectangle is intersecting.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param rects An array of rectangles in RAM.
+   * \param count The number of rectangles in the array.
+   *
+   * \return The index in the array of the first rectangle that `rect` is
+   * intersecting, or -1 if there are none.
+   *
+   * \details
+   * The rectangles are tested in order the same way as by
+   * `collide(Rect, Rect)`, and testing stops at the first one that `rect`
+   * is intersecting. This is much faster than calling `collide()` for each
+   * rectangle, such as to test an object against the walls of a level.
+   *
+   * \see collideAny_P() collideAll() collide(Rect, Rect) Rect
+   */
+  static int16_t collideAny(const Rect &rect, const Rect *rects, uint8_t count);
+
+  /** \brief
+   * Find the first point in an array that falls within a rectangle.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param points An array of points in RAM.
+   * \param count The number of points in the array.
+   *
+   * \return The index in the array of the first point that is within
+   * `rect`, or -1 if there are none.
+   *
+   * \details
+   * The points are tested in order the same way as by `collide(Point, Rect)`,
+   * and testing stops at the first one within `rect`.
+   *
+   * \see collideAny_P() collideAll() collide(Point, Rect) Point
+   */
+  static int16_t collideAny(const Rect &rect, const Point *points, uint8_t count);
+
+  /** \brief
+   * Find the first rectangle in an array in program memory that a rectangle
+   * is intersecting.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param rects An array of rectangles in program memory.
+   * \param count The number of rectangles in the array.
+   *
+   * \return The index in the array of the first rectangle that `rect` is
+   * intersecting, or -1 if there are none.
+   *
+   * \details
+   * This is the same as `collideAny()` except that the array is in program
+   * memory, such as the fixed walls of a level.
+   *
+   * \see collideAny() collideAll_P()
+   */
+  static int16_t collideAny_P(const Rect &rect, const Rect *rects, uint8_t count);
+
+  /** \brief
+   * Find the first point in an array in program memory that falls within a
+   * rectangle.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param points An array of points in program memory.
+   * \param count The number of points in the array.
+   *
+   * \return The index in the array of the first point that is within
+   * `rect`, or -1 if there are none.
+   *
+   * \details
+   * This is the same as `collideAny()` except that the array is in program
+   * memory.
+   *
+   * \see collideAny() collideAll_P()
+   */
+  static int16_t collideAny_P(const Rect &rect, const Point *points, uint8_t count);
+
+  /** \brief
+   * Find all the rectangles in an array that a rectangle is intersecting.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param rects An array of rectangles in RAM.
+   * \param count The number of rectangles in the array.
+   * \param hits An array of at least `(count + 7) / 8` bytes, which is set
+   * to a bit for each rectangle in the array.
+   *
+   * \return The number of rectangles that `rect` is intersecting.
+   *
+   * \details
+   * Each rectangle is tested the same way as by `collide(Rect, Rect)`. The
+   * bit for the rectangle at index `i` of the array is bit `i % 8` of
+   * `hits[i / 8]`. It's set to 1 if `rect` is intersecting the rectangle,
+   * and 0 if it isn't.
+   *
+   * \code{.cpp}
+   * uint8_t hits[(ENEMY_COUNT + 7) / 8];
+   *
+   * if (arduboy.collideAll(blast, enemies, ENEMY_COUNT, hits) != 0) {
+   *   for (uint8_t i = 0; i < ENEMY_COUNT; i++) {
+   *     if (hits[i / 8] & (1 << (i % 8))) {
+   *       destroyEnemy(i);
+   *     }
+   *   }
+   * }
+   * \endcode
+   *
+   * \see collideAll_P() collideAny() collide(Rect, Rect) Rect
+   */
+  static uint8_t collideAll(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits);
+
+  /** \brief
+   * Find all the points in an array that fall within a rectangle.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param points An array of points in RAM.
+   * \param count The number of points in the array.
+   * \param hits An array of at least `(count + 7) / 8` bytes, which is set
+   * to a bit for each point in the array.
+   *
+   * \return The number of points within `rect`.
+   *
+   * \details
+   * Each point is tested the same way as by `collide(Point, Rect)`. The bit
+   * for the point at index `i` of the array is bit `i % 8` of `hits[i / 8]`.
+   * It's set to 1 if the point is within `rect`, and 0 if it isn't.
+   *
+   * \see collideAll_P() collideAny() collide(Point, Rect) Point
+   */
+  static uint8_t collideAll(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits);
+
+  /** \brief
+   * Find all the rectangles in an array in program memory that a rectangle
+   * is intersecting.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param rects An array of rectangles in program memory.
+   * \param count The number of rectangles in the array.
+   * \param hits An array in RAM of at least `(count + 7) / 8` bytes, which
+   * is set to a bit for each rectangle in the array.
+   *
+   * \return The number of rectangles that `rect` is intersecting.
+   *
+   * \details
+   * This is the same as `collideAll()` except that the array of rectangles
+   * is in program memory.
+   *
+   * \see collideAll() collideAny_P()
+   */
+  static uint8_t collideAll_P(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits);
+
+  /** \brief
+   * Find all the points in an array in program memory that fall within a
+   * rectangle.
+   *
+   * \param rect A structure describing the location and size of the
+   * rectangle to test.
+   * \param points An array of points in program memory.
+   * \param count The number of points in the array.
+   * \param hits An array in RAM of at least `(count + 7) / 8` bytes, which
+   * is set to a bit for each point in the array.
+   *
+   * \return The number of points within `rect`.
+   *
+   * \details
+   * This is the same as `collideAll()` except that the array of points is
+   * in program memory.
+   *
+   * \see collideAll() collideAny_P()
+   */
+  static uint8_t collideAll_P(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits);
+
   /** \brief
    * Read the unit ID from system EEPROM.
    *
@@ -1327,6 +2165,56 @@ class Arduboy2Base : public Arduboy2Core
   static void drawLogoSpritesBSelfMasked(int16_t y);
   static void drawLogoSpritesBOverwrite(int16_t y);
 
+  // Fill a vertical span of a column, with only the pixels set in the
+  // pattern byte being changed. Used by drawFastVLine() and the fill functions.
+  static void fillColumn(int16_t x, int16_t y, uint8_t h, uint8_t color, uint8_t pattern);
+
+  // fillTriangle() with an optional fill pattern (NULL for a solid fill)
+  void fillTriangleSpans(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color, const uint8_t *pattern);
+
+  // Master functions for collideAny() and collideAll(), with the array in
+  // RAM or program memory. The memory type is a template parameter, so each
+  // one gets its own loop. If hits is NULL, testing stops at the first hit
+  // and its index is returned, or count if there are none. Otherwise, the
+  // bit for each hit is set in hits and the number of hits is returned.
+  template<bool inProgmem>
+  static uint8_t collideRects(const Rect &rect, const Rect *rects, uint8_t count, uint8_t *hits);
+  template<bool inProgmem>
+  static uint8_t collidePoints(const Rect &rect, const Point *points, uint8_t count, uint8_t *hits);
+
+  // Master function for drawBitmap() and drawBitmapRAM(). The memory
+  // type is a template parameter, so each one gets its own byte loop.
+  template<bool inProgmem>
+  static void bitmapDraw(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color);
+
+  // Master functions for the polygon functions, with the points in RAM or
+  // program memory
+  void polygonOutline(const Point *points, uint8_t count, uint8_t color, bool inProgmem);
+  void polygonFill(const Point *points, uint8_t count, uint8_t color, bool inProgmem);
+  void convexPolygonFill(const Point *points, uint8_t count, uint8_t color, bool inProgmem);
+
+  // The area of sBuffer changed since it was last sent to the display,
+  // as columns and pages. Empty when dirtyStartX > dirtyEndX.
+  static uint8_t dirtyStartX;
+  static uint8_t dirtyEndX;
+  static uint8_t dirtyStartPage;
+  static uint8_t dirtyEndPage;
+
+  // Reset the changed area to empty
+  static void clearDirty();
+
+  // The display buffer row shown at the top of the screen, for scrollDisplay()
+  static uint8_t scrollLine;
+
+#ifdef CLIP_RECT_MODE
+  // Clip rectangles saved by pushClipRect(), as left, top, right, bottom
+  static uint8_t clipStack[CLIP_STACK_DEPTH][4];
+  static uint8_t clipDepth;
+#endif
+
+  // The copy of the display buffer being sent by displayAsync()
+  static uint8_t asyncBuffer[(HEIGHT*WIDTH)/8];
+
   // For button handling
   uint8_t currentButtonState;
   uint8_t previousButtonState;
@@ -1601,6 +2489,9 @@ class Arduboy2 : public Print, public Arduboy2Base
    * size so they will occupy 12x16 pixels. A value of 3 will result in
    * 18x24, etc.
    *
+   * Text sizes of 1, 2 and 4 are drawn a byte at a time and are much faster
+   * than other sizes.
+   *
    * \see getTextSize()
    */
   void setTextSize(uint8_t s);
@@ -72,6 +72,13 @@ const uint8_t PROGMEM lcdBootProgram[] = {
   // 0x22, 0x00, PAGE_ADDRESS_END
 };
 
+uint16_t Arduboy2Core::pageChecksums[];
+uint8_t Arduboy2Core::pagesValid = 0;
+uint8_t Arduboy2Core::pagesSkippedCount = 0;
+
+uint8_t *Arduboy2Core::asyncImage;
+uint8_t Arduboy2Core::asyncPagesLeft;
+bool Arduboy2Core::asyncClear;
 
 Arduboy2Core::Arduboy2Core() { }
 
@@ -387,6 +394,153 @@ void Arduboy2Core::paintScreen(uint8_t image[], bool clear)
 }
 #endif
 
+void Arduboy2Core::paintRegion(const uint8_t image[], uint8_t x0, uint8_t page0,
+                               uint8_t x1, uint8_t page1)
+{
+  setDisplayWindow(x0, x1, page0, page1);
+
+  for (uint8_t page = page0; page <= page1; page++)
+  {
+    const uint8_t *p = image + (page * WIDTH) + x0;
+    for (uint8_t i = x1 - x0 + 1; i != 0; i--)
+    {
+      SPItransfer(*p++);
+    }
+  }
+
+  // restore the full display window for paintScreen()
+  setDisplayWindow(0, COLUMN_ADDRESS_END, 0, PAGE_ADDRESS_END);
+}
+
+void Arduboy2Core::setDisplayWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+  LCDCommandMode();
+  SPItransfer(OLED_SET_COLUMN_ADDRESS);
+  SPItransfer(x0);
+  SPItransfer(x1);
+  SPItransfer(OLED_SET_PAGE_ADDRESS);
+  SPItransfer(page0);
+  SPItransfer(page1);
+  LCDDataMode();
+}
+
+void Arduboy2Core::paintChangedPages(uint8_t image[], bool clear)
+{
+  // The display address is left at the start of the next page after a
+  // page is sent, so it only has to be set again after a page is skipped
+  bool inPlace = true;
+  uint8_t skipped = 0;
+
+  for (uint8_t page = 0; page < HEIGHT / 8; page++)
+  {
+    uint8_t *p = image + (page * WIDTH);
+    uint16_t sum = 0;
+
+    // Each byte is weighted by a different power of 3, so moving or
+    // toggling a single pixel always changes the sum
+    for (uint8_t i = 0; i < WIDTH; i++)
+    {
+      sum += (sum << 1) + p[i];
+    }
+
+    if ((pagesValid & _BV(page)) && (sum == pageChecksums[page]))
+    {
+      skipped++;
+      inPlace = false;
+      if (clear)
+      {
+        memset(p, 0, WIDTH);
+      }
+      continue;
+    }
+
+    pageChecksums[page] = sum;
+    if (!inPlace)
+    {
+      setDisplayWindow(0, COLUMN_ADDRESS_END, page, PAGE_ADDRESS_END);
+      inPlace = true;
+    }
+
+    paintPage(p, clear);
+  }
+
+  pagesValid = 0xFF;
+  pagesSkippedCount = skipped;
+
+  // put the display address back at the top left for paintScreen()
+  if (skipped != 0)
+  {
+    setDisplayWindow(0, COLUMN_ADDRESS_END, 0, PAGE_ADDRESS_END);
+  }
+}
+
+uint8_t Arduboy2Core::pagesSkipped()
+{
+  return pagesSkippedCount;
+}
+
+void Arduboy2Core::resetPageChecksums()
+{
+  pagesValid = 0;
+}
+
+void Arduboy2Core::paintScreenAsync(uint8_t image[], bool clear)
+{
+  waitDisplay();
+
+  asyncImage = image;
+  asyncClear = clear;
+  asyncPagesLeft = HEIGHT / 8;
+
+  // the first page will be sent at the next timer 0 compare B match
+  TIFR0 = _BV(OCF0B); // clear any old match (by writing a 1)
+  bitSet(TIMSK0, OCIE0B);
+}
+
+bool Arduboy2Core::displayBusy()
+{
+  return bitRead(TIMSK0, OCIE0B);
+}
+
+void Arduboy2Core::waitDisplay()
+{
+  while (displayBusy()) { }
+}
+
+// Called from the timer 0 compare B interrupt set up by ARDUBOY_ASYNC_DISPLAY
+void Arduboy2Core::paintAsyncPage()
+{
+  paintPage(asyncImage, asyncClear);
+  asyncImage += WIDTH;
+
+  if (--asyncPagesLeft == 0)
+  {
+    bitClear(TIMSK0, OCIE0B);
+  }
+}
+
+// Send one page (WIDTH bytes) of an image, optionally clearing it.
+// The next byte is fetched (and cleared) while the previous one is sent.
+void Arduboy2Core::paintPage(uint8_t *image, bool clear)
+{
+  SPDR = *image;
+  for (uint8_t i = WIDTH - 1; i != 0; i--)
+  {
+    if (clear)
+    {
+      *image = 0;
+    }
+    uint8_t c = *++image;
+    while (!(SPSR & _BV(SPIF))) { } // wait for the previous byte to be sent
+    SPDR = c;
+  }
+  if (clear)
+  {
+    *image = 0;
+  }
+  while (!(SPSR & _BV(SPIF))) { } // wait for the last byte to be sent
+}
+
 void Arduboy2Core::blank()
 {
   for (int i = 0; i < (HEIGHT*WIDTH)/8; i++)
@@ -426,6 +580,54 @@ void Arduboy2Core::flipHorizontal(bool flipped)
   sendLCDCommand(flipped ? OLED_HORIZ_FLIPPED : OLED_HORIZ_NORMAL);
 }
 
+// set the display RAM row shown at the top of the screen
+void Arduboy2Core::setStartLine(uint8_t line)
+{
+  sendLCDCommand(OLED_SET_START_LINE | (line & (HEIGHT - 1)));
+}
+
+void Arduboy2Core::scrollHorizontal(bool left, uint8_t page0, uint8_t page1, uint8_t interval)
+{
+  LCDCommandMode();
+  SPItransfer(left ? OLED_SCROLL_LEFT : OLED_SCROLL_RIGHT);
+  SPItransfer(0x00); // dummy byte
+  SPItransfer(page0);
+  SPItransfer(interval);
+  SPItransfer(page1);
+  SPItransfer(0x00); // dummy byte
+  SPItransfer(0xFF); // dummy byte
+  SPItransfer(OLED_SCROLL_ON);
+  LCDDataMode();
+}
+
+void Arduboy2Core::scrollDiagonal(bool left, uint8_t page0, uint8_t page1,
+                                  uint8_t interval, uint8_t rowStep)
+{
+  LCDCommandMode();
+  SPItransfer(left ? OLED_SCROLL_VERT_LEFT : OLED_SCROLL_VERT_RIGHT);
+  SPItransfer(0x00); // dummy byte
+  SPItransfer(page0);
+  SPItransfer(interval);
+  SPItransfer(page1);
+  SPItransfer(rowStep);
+  SPItransfer(OLED_SCROLL_ON);
+  LCDDataMode();
+}
+
+void Arduboy2Core::setVerticalScrollArea(uint8_t fixedRows, uint8_t scrollRows)
+{
+  LCDCommandMode();
+  SPItransfer(OLED_SET_SCROLL_AREA);
+  SPItransfer(fixedRows);
+  SPItransfer(scrollRows);
+  LCDDataMode();
+}
+
+void Arduboy2Core::stopScroll()
+{
+  sendLCDCommand(OLED_SCROLL_OFF);
+}
+
 /* RGB LED */
 
 void Arduboy2Core::setRGBled(uint8_t red, uint8_t green, uint8_t blue)
@@ -243,6 +243,18 @@
 #define OLED_HORIZ_FLIPPED 0xA0 // reversed segment re-map
 #define OLED_HORIZ_NORMAL 0xA1 // normal segment re-map
 
+#define OLED_SET_COLUMN_ADDRESS 0x21 // set column start and end address
+#define OLED_SET_PAGE_ADDRESS 0x22 // set page start and end address
+
+#define OLED_SET_START_LINE 0x40 // set display start line (OR with line 0-63)
+#define OLED_SET_SCROLL_AREA 0xA3 // set vertical scroll area
+#define OLED_SCROLL_RIGHT 0x26 // set up continuous horizontal scroll right
+#define OLED_SCROLL_LEFT 0x27 // set up continuous horizontal scroll left
+#define OLED_SCROLL_VERT_RIGHT 0x29 // set up vertical and right scroll
+#define OLED_SCROLL_VERT_LEFT 0x2A // set up vertical and left scroll
+#define OLED_SCROLL_OFF 0x2E // stop scrolling
+#define OLED_SCROLL_ON 0x2F // start scrolling
+
 // -----
 
 #define WIDTH 128 /**< The width of the display in pixels */
@@ -313,6 +325,45 @@ int main() { \
   return 0; \
 }
 
+/** \brief
+ * Enable the interrupt used to send the display buffer in the background.
+ *
+ * \details
+ * \parblock
+ * This macro must be placed in the sketch, outside of any function, if
+ * `Arduboy2Core::paintScreenAsync()`, `Arduboy2Base::displayAsync()` or
+ * `Arduboy2Base::displayAsyncInPlace()` are used. It defines the interrupt
+ * service routine that sends the image, one page (8 pixel high row) per
+ * interrupt, so the interrupt code is only included in sketches that use it:
+ *
+ * \code{.cpp}
+ * #include <Arduboy2.h>
+ *
+ * Arduboy2 arduboy;
+ *
+ * // Include the background display interrupt
+ * ARDUBOY_ASYNC_DISPLAY
+ *
+ * void setup() {
+ *   arduboy.begin();
+ * }
+ * \endcode
+ *
+ * The timer 0 compare B interrupt is used. Timer 0 also provides the Arduino
+ * `millis()` timing, which it isn't affected by, so one page is sent about
+ * every 1.024 milliseconds.
+ * \endparblock
+ *
+ * \note
+ * **WARNING:** If a sketch starts a background transfer without including
+ * this macro, the interrupt will have no handler and the Arduboy will reset.
+ *
+ * \see Arduboy2Core::paintScreenAsync()
+ */
+#define ARDUBOY_ASYNC_DISPLAY ISR(TIMER0_COMPB_vect) { \
+  Arduboy2Core::paintAsyncPage(); \
+}
+
 
 /** \brief
  * Lower level functions generally dealing directly with the hardware.
@@ -534,6 +585,173 @@ class Arduboy2Core
      */
     void static paintScreen(uint8_t image[], bool clear = false);
 
+    /** \brief
+     * Paints a rectangular area of an image in RAM to the display.
+     *
+     * \param image A byte array in RAM representing the entire contents of
+     * the display.
+     * \param x0,x1 The first and last columns (0 to WIDTH - 1) to be painted.
+     * \param page0,page1 The first and last pages (8 pixel high rows,
+     * 0 to HEIGHT / 8 - 1) to be painted.
+     *
+     * \details
+     * Only the bytes of the array within the specified columns and pages are
+     * written to the display, at the same position they occupy in the array.
+     * The rest of the display is left unchanged. The array uses the same
+     * format as for `paintScreen()`.
+     *
+     * The display's address window is set to the area being painted and then
+     * restored to the entire display, so `paintScreen()` will continue to work
+     * as expected afterwards.
+     *
+     * \see paintScreen() setDisplayWindow()
+     */
+    void static paintRegion(const uint8_t image[], uint8_t x0, uint8_t page0,
+                            uint8_t x1, uint8_t page1);
+
+    /** \brief
+     * Set the area of the display that following data will be written to.
+     *
+     * \param x0,x1 The first and last columns (0 to WIDTH - 1) of the window.
+     * \param page0,page1 The first and last pages (8 pixel high rows,
+     * 0 to HEIGHT / 8 - 1) of the window.
+     *
+     * \details
+     * The display controller's column and page address ranges are set to the
+     * given values and the address is moved to the top left of the window.
+     * Data bytes sent to the display will then fill the window left to right,
+     * top to bottom, wrapping back to the top left of the window at the end.
+     *
+     * \note
+     * `paintScreen()` and `blank()` assume the window covers the entire
+     * display. If this function is used directly, the full display window
+     * must be restored before using them again:
+     *
+     * \code{.cpp}
+     * setDisplayWindow(0, WIDTH - 1, 0, HEIGHT / 8 - 1);
+     * \endcode
+     *
+     * \see paintRegion()
+     */
+    void static setDisplayWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+
+    /** \brief
+     * Paints only the pages of an image in RAM that have changed since the
+     * previous call.
+     *
+     * \param image A byte array in RAM representing the entire contents of
+     * the display.
+     * \param clear If `true` the array in RAM will be cleared to zeros upon
+     * return from this function. If `false` the RAM buffer will remain
+     * unchanged. (optional; defaults to `false`)
+     *
+     * \details
+     * This works the same as `paintScreen(uint8_t image[], bool clear)` except
+     * that a 16 bit checksum is kept for each page (8 pixel high row) of the
+     * image. A page that has the same checksum as when it was last painted
+     * isn't sent to the display. This only needs 16 bytes of RAM, instead of
+     * the 1024 that a full copy of the previous frame would take.
+     *
+     * Calculating a page's checksum takes a good part of the time that
+     * sending it would, so this is only faster than `paintScreen()` when
+     * most of the pages of a frame are usually unchanged. `pagesSkipped()`
+     * can be used to find out how many pages are being skipped.
+     *
+     * \note
+     * The checksums only know about what this function has sent. If anything
+     * else is drawn on the display, such as by `paintScreen()`, call
+     * `resetPageChecksums()` so that the next call will paint every page.
+     * \n
+     * Two different page images can have the same checksum, in which case the
+     * page won't be updated until it changes again. The checksum will always
+     * detect a single pixel being turned on or off, or moved within a page.
+     * Any other change has about a 1 in 65536 chance of going undetected.
+     *
+     * \see pagesSkipped() resetPageChecksums() paintScreen()
+     */
+    void static paintChangedPages(uint8_t image[], bool clear = false);
+
+    /** \brief
+     * Get the number of pages that weren't sent by the last call to
+     * `paintChangedPages()`.
+     *
+     * \return The number of unchanged pages that were skipped, from 0 to
+     * HEIGHT / 8.
+     *
+     * \see paintChangedPages()
+     */
+    uint8_t static pagesSkipped();
+
+    /** \brief
+     * Make the next call to `paintChangedPages()` paint every page.
+     *
+     * \details
+     * The saved page checksums are discarded. This should be called after
+     * the display has been written to by anything other than
+     * `paintChangedPages()`.
+     *
+     * \see paintChangedPages()
+     */
+    void static resetPageChecksums();
+
+    /** \brief
+     * Start sending an image in RAM to the display in the background.
+     *
+     * \param image A byte array in RAM representing the entire contents of
+     * the display.
+     * \param clear If `true` each page of the array will be cleared to zeros
+     * after it has been sent. If `false` the array will remain unchanged.
+     * (optional; defaults to `false`)
+     *
+     * \details
+     * This produces the same result as
+     * `paintScreen(uint8_t image[], bool clear)` but returns immediately.
+     * The image is then sent one page (8 pixel high row) at a time, by an
+     * interrupt that occurs about once per millisecond, so the whole image
+     * will have been sent after about 8 milliseconds. If a previous transfer
+     * is still in progress, this function waits for it to finish first.
+     *
+     * The array must not be changed, and nothing else may be sent to the
+     * display, until the transfer has finished. `displayBusy()` or
+     * `waitDisplay()` can be used to check for this.
+     *
+     * The microcontroller has no DMA so the bytes are still sent by the CPU,
+     * taking the same amount of time as `paintScreen()` in total. This doesn't
+     * make the sketch faster but lets it carry on with other work, such as
+     * game logic that doesn't draw, instead of waiting for the whole transfer.
+     * Other interrupts, such as for sound, may be delayed by up to the time
+     * it takes to send a page.
+     *
+     * \note
+     * The `ARDUBOY_ASYNC_DISPLAY` macro must be included in the sketch to use
+     * this function.
+     *
+     * \see displayBusy() waitDisplay() ARDUBOY_ASYNC_DISPLAY
+     * Arduboy2Base::displayAsync() Arduboy2Base::displayAsyncInPlace()
+     */
+    void static paintScreenAsync(uint8_t image[], bool clear = false);
+
+    /** \brief
+     * Check if a background transfer to the display is in progress.
+     *
+     * \return `true` if an image started by `paintScreenAsync()` is still
+     * being sent.
+     *
+     * \see paintScreenAsync() waitDisplay()
+     */
+    bool static displayBusy();
+
+    /** \brief
+     * Wait until a background transfer to the display has finished.
+     *
+     * \details
+     * If no transfer started by `paintScreenAsync()` is in progress, this
+     * function returns immediately.
+     *
+     * \see paintScreenAsync() displayBusy()
+     */
+    void static waitDisplay();
+
     /** \brief
      * Blank the display screen by setting all pixels off.
      *
@@ -617,6 +835,105 @@ class Arduboy2Core
      */
     void static flipHorizontal(bool flipped);
 
+    /** \brief
+     * Set the row of the display's RAM shown at the top of the screen.
+     *
+     * \param line The display RAM row (0 to HEIGHT - 1) to be shown at the
+     * top of the screen.
+     *
+     * \details
+     * The display shows its RAM starting at the given row, wrapping back to
+     * row 0 after the last row. Screen row `r` will show RAM row
+     * `(r + line) % HEIGHT`. Changing the start line moves the whole image
+     * up or down without sending any image data.
+     *
+     * The start line is 0 after the display is initialized.
+     *
+     * \see Arduboy2Base::scrollDisplay()
+     */
+    void static setStartLine(uint8_t line);
+
+    /** \brief
+     * Start the display continuously scrolling horizontally.
+     *
+     * \param left `true` to scroll to the left. `false` to scroll to the
+     * right.
+     * \param page0,page1 The first and last pages (8 pixel high rows,
+     * 0 to HEIGHT / 8 - 1) to be scrolled.
+     * \param interval The time between each 1 pixel step, as a display
+     * controller frame interval code (0 to 7): 7 = 2 frames, 4 = 3 frames,
+     * 5 = 4 frames, 0 = 5 frames, 6 = 25 frames, 1 = 64 frames,
+     * 2 = 128 frames, 3 = 256 frames.
+     *
+     * \details
+     * The display controller rotates the contents of the given pages by one
+     * column each step, with no further action needed by the sketch.
+     *
+     * \note
+     * Image data must not be sent to the display while scrolling is active.
+     * Call `stopScroll()` first. When scrolling is stopped, the display's RAM
+     * will have been rotated, so the image should be sent again.
+     *
+     * \see scrollDiagonal() stopScroll()
+     */
+    void static scrollHorizontal(bool left, uint8_t page0, uint8_t page1, uint8_t interval);
+
+    /** \brief
+     * Start the display continuously scrolling vertically and horizontally.
+     *
+     * \param left `true` to scroll to the left. `false` to scroll to the
+     * right.
+     * \param page0,page1 The first and last pages (0 to HEIGHT / 8 - 1) to be
+     * scrolled horizontally.
+     * \param interval The time between each step, as a frame interval code.
+     * See `scrollHorizontal()`.
+     * \param rowStep The number of rows (0 to HEIGHT - 1) to scroll up by
+     * each step. A value of 0 gives only horizontal scrolling.
+     *
+     * \details
+     * The rows within the vertical scroll area move up by `rowStep` each
+     * step, while the given pages also move by one column. The vertical
+     * scroll area is the entire display unless changed using
+     * `setVerticalScrollArea()`.
+     *
+     * \note
+     * The same restrictions as for `scrollHorizontal()` apply.
+     *
+     * \see scrollHorizontal() setVerticalScrollArea() stopScroll()
+     */
+    void static scrollDiagonal(bool left, uint8_t page0, uint8_t page1,
+                               uint8_t interval, uint8_t rowStep);
+
+    /** \brief
+     * Set the rows of the display that `scrollDiagonal()` moves vertically.
+     *
+     * \param fixedRows The number of rows at the top of the display that
+     * don't scroll vertically.
+     * \param scrollRows The number of rows below the fixed rows that scroll
+     * vertically.
+     *
+     * \details
+     * This can be used to keep a status area at the top of the screen fixed
+     * while the rest of the screen scrolls. `fixedRows + scrollRows` must not
+     * be greater than HEIGHT.
+     *
+     * \see scrollDiagonal()
+     */
+    void static setVerticalScrollArea(uint8_t fixedRows, uint8_t scrollRows);
+
+    /** \brief
+     * Stop continuous scrolling started by `scrollHorizontal()` or
+     * `scrollDiagonal()`.
+     *
+     * \details
+     * Stopping a scroll leaves the display's RAM in its scrolled position,
+     * which won't match the image last sent. Sending the image again will
+     * restore the display.
+     *
+     * \see scrollHorizontal() scrollDiagonal()
+     */
+    void static stopScroll();
+
     /** \brief
      * Send a single command byte to the display.
      *
@@ -839,6 +1156,11 @@ class Arduboy2Core
     // directly from a sketch.
     void static mainNoUSB();
 
+    // Sends the next page of a paintScreenAsync() transfer.
+    // Used by the ARDUBOY_ASYNC_DISPLAY macro. This should not be called
+    // directly from a sketch.
+    void static paintAsyncPage();
+
   protected:
     // internals
     void static setCPUSpeed8MHz();
@@ -846,6 +1168,19 @@ class Arduboy2Core
     void static bootOLED();
     void static bootPins();
     void static bootPowerSaving();
+
+    // Send one page (WIDTH bytes) of an image, optionally clearing it
+    void static paintPage(uint8_t *image, bool clear);
+
+    // For paintChangedPages()
+    static uint16_t pageChecksums[HEIGHT / 8];
+    static uint8_t pagesValid; // bit set for each page with a valid checksum
+    static uint8_t pagesSkippedCount;
+
+    // For paintScreenAsync()
+    static uint8_t *asyncImage; // the next page to be sent
+    static uint8_t asyncPagesLeft;
+    static bool asyncClear;
 };
 
 #endif
@@ -0,0 +1,257 @@
+/**
+ * @file CollisionGrid.h
+ * \brief
+ * A class template for finding which of many rectangles may be colliding,
+ * using a grid of cells covering the screen.
+ */
+
+#ifndef CollisionGrid_h
+#define CollisionGrid_h
+
+#include "Arduboy2.h"
+
+/** \brief
+ * A class template for finding which of many rectangles may be colliding,
+ * using a grid of cells covering the screen.
+ *
+ * \tparam maxObjects The number of objects that can be put in the grid. Each
+ * object is given an ID from 0 to `maxObjects - 1`, such as its index in the
+ * sketch's array of enemies. The maximum is 254.
+ * \tparam maxEntries The number of grid cells, in total, that the objects
+ * can be in. An object is put in each cell that its rectangle touches, so
+ * this should be a little more than `maxObjects` for objects smaller than a
+ * cell. The default is twice `maxObjects` and the maximum is 254.
+ * \tparam cellWidth,cellHeight The width and height of each cell, in pixels.
+ * The defaults of 16 and 8 divide the screen into an 8 by 8 grid. The grid
+ * can't be more than 16 cells wide or high.
+ *
+ * \details
+ * Testing every one of a set of objects, such as bullets, against every one
+ * of another set, such as enemies, using `Arduboy2Base::collide(Rect, Rect)`
+ * takes a time proportional to the product of the number of objects in each
+ * set. With a collision grid, the rectangles of one set are put in the cells
+ * that they touch, using `insert()`. Each object of the other set then only
+ * needs to be tested against the objects in the cells that its own rectangle
+ * touches, which are found using `query()`. This makes the time taken about
+ * proportional to the total number of objects.
+ *
+ * All the memory used is part of the object. Its size, in bytes, is about:
+ *
+ *     maxObjects + (2 * maxEntries) + (number of cells) + 1
+ *
+ * The objects in different cells are only candidates for a collision, so each
+ * one found by `query()` should then be tested using
+ * `Arduboy2Base::collide()`, or `Sprites::collide()` for the sprites' pixels.
+ * Rectangles that are partly or completely off the screen are put in the
+ * cells at the edges of the screen, so they're still found.
+ *
+ * The `CollisionGrid.h` header file must be included to use this class:
+ *
+ * \code{.cpp}
+ * #include <Arduboy2.h>
+ * #include <CollisionGrid.h>
+ *
+ * CollisionGrid<20, 40> grid;
+ *
+ * // in the game loop
+ * grid.clear();
+ * for (uint8_t i = 0; i < enemyCount; i++) {
+ *   grid.insert(i, enemies[i].rect);
+ * }
+ *
+ * for (uint8_t b = 0; b < bulletCount; b++) {
+ *   uint8_t found[20];
+ *   uint8_t count = grid.query(bullets[b].rect, found, 20);
+ *
+ *   for (uint8_t i = 0; i < count; i++) {
+ *     if (Arduboy2Base::collide(bullets[b].rect, enemies[found[i]].rect)) {
+ *       hitEnemy(found[i]);
+ *     }
+ *   }
+ * }
+ * \endcode
+ *
+ * \see Arduboy2Base::collide(Rect, Rect) Rect
+ */
+template<uint8_t maxObjects,
+         uint8_t maxEntries = (maxObjects < 127) ? maxObjects * 2 : 254,
+         uint8_t cellWidth = 16, uint8_t cellHeight = 8>
+class CollisionGrid
+{
+  static_assert(maxObjects > 0 && maxObjects < 255,
+                "CollisionGrid: maxObjects must be from 1 to 254");
+  static_assert(maxEntries > 0 && maxEntries < 255,
+                "CollisionGrid: maxEntries must be from 1 to 254");
+  static_assert(cellWidth > 0 && cellHeight > 0,
+                "CollisionGrid: the cell size can't be 0");
+
+  // the number of cells across and down the screen
+  static const uint8_t columns = (WIDTH + cellWidth - 1) / cellWidth;
+  static const uint8_t rows = (HEIGHT + cellHeight - 1) / cellHeight;
+
+  static_assert(columns <= 16 && rows <= 16,
+                "CollisionGrid: the grid can't be more than 16 cells wide or high");
+
+  // marks the end of a cell's list of entries
+  static const uint8_t none = 0xFF;
+
+  public:
+    /** \brief
+     * The constructor. The grid starts out empty.
+     */
+    CollisionGrid()
+    {
+      clear();
+    }
+
+    /** \brief
+     * Remove all the objects from the grid.
+     *
+     * \details
+     * This is usually called at the start of each frame, before inserting
+     * the objects at their new locations.
+     */
+    void clear()
+    {
+      for (uint16_t i = 0; i < columns * rows; i++) {
+        cellHead[i] = none;
+      }
+      entryCount = 0;
+    }
+
+    /** \brief
+     * Put an object in the cells that its rectangle touches.
+     *
+     * \param id The object's ID, from 0 to `maxObjects - 1`. This is what
+     * `query()` returns for the object.
+     * \param rect The object's rectangle.
+     *
+     * \return `true` if the object was put in the grid. `false` if the ID
+     * is too large, or there aren't enough entries left for all the cells
+     * that the rectangle touches. The object isn't put in any cells if
+     * `false` is returned.
+     *
+     * \details
+     * Each ID should only be inserted once after `clear()` is called.
+     */
+    bool insert(uint8_t id, Rect rect)
+    {
+      if (id >= maxObjects) {
+        return false;
+      }
+
+      uint8_t col0, row0, col1, row1;
+      cellRange(rect, col0, row0, col1, row1);
+
+      if ((col1 - col0 + 1) * (row1 - row0 + 1) > maxEntries - entryCount) {
+        return false;
+      }
+
+      // the first cell is kept, so query() can report the object only once
+      objectFirstCell[id] = (col0 << 4) | row0;
+
+      for (uint8_t row = row0; row <= row1; row++) {
+        for (uint8_t col = col0; col <= col1; col++) {
+          uint8_t cell = (row * columns) + col;
+          entryId[entryCount] = id;
+          entryNext[entryCount] = cellHead[cell];
+          cellHead[cell] = entryCount++;
+        }
+      }
+      return true;
+    }
+
+    /** \brief
+     * Find the objects in the cells that a rectangle touches.
+     *
+     * \param rect The rectangle to look for objects near.
+     * \param ids An array to be filled with the IDs of the objects found.
+     * \param maxIds The number of IDs that the `ids` array can hold.
+     *
+     * \return The number of IDs put in the `ids` array.
+     *
+     * \details
+     * Each object found is only returned once, even if it's in more than one
+     * of the cells. The objects found are candidates for a collision with the
+     * rectangle, which should each be tested with `Arduboy2Base::collide()`.
+     * Any more than `maxIds` objects aren't returned.
+     */
+    uint8_t query(Rect rect, uint8_t *ids, uint8_t maxIds) const
+    {
+      uint8_t col0, row0, col1, row1;
+      cellRange(rect, col0, row0, col1, row1);
+
+      uint8_t count = 0;
+
+      for (uint8_t row = row0; row <= row1; row++) {
+        for (uint8_t col = col0; col <= col1; col++) {
+          uint8_t entry = cellHead[(row * columns) + col];
+
+          while (entry != none) {
+            uint8_t id = entryId[entry];
+
+            // An object in more than one of the cells is only returned
+            // for the first cell that it and the rectangle have in common
+            uint8_t firstCol = objectFirstCell[id] >> 4;
+            uint8_t firstRow = objectFirstCell[id] & 0x0F;
+            if (col == (firstCol > col0 ? firstCol : col0) &&
+                row == (firstRow > row0 ? firstRow : row0)) {
+              if (count == maxIds) {
+                return count;
+              }
+              ids[count++] = id;
+            }
+            entry = entryNext[entry];
+          }
+        }
+      }
+      return count;
+    }
+
+  private:
+    // Get the first and last cell columns and rows that a rectangle touches.
+    // Anything off the screen is in the cells at its edges.
+    static void cellRange(Rect rect, uint8_t &col0, uint8_t &row0,
+                          uint8_t &col1, uint8_t &row1)
+    {
+      col0 = cellColumn(rect.x);
+      row0 = cellRow(rect.y);
+      col1 = cellColumn(rect.x + (rect.width > 0 ? rect.width - 1 : 0));
+      row1 = cellRow(rect.y + (rect.height > 0 ? rect.height - 1 : 0));
+    }
+
+    static uint8_t cellColumn(int16_t x)
+    {
+      if (x < 0) {
+        return 0;
+      }
+      if (x >= WIDTH) {
+        return columns - 1;
+      }
+      return (uint8_t)x / cellWidth;
+    }
+
+    static uint8_t cellRow(int16_t y)
+    {
+      if (y < 0) {
+        return 0;
+      }
+      if (y >= HEIGHT) {
+        return rows - 1;
+      }
+      return (uint8_t)y / cellHeight;
+    }
+
+    // the first entry in each cell's list, or none
+    uint8_t cellHead[columns * rows];
+
+    // each entry is an object in a cell, linked to the next entry in the cell
+    uint8_t entryId[maxEntries];
+    uint8_t entryNext[maxEntries];
+    uint8_t entryCount;
+
+    // the column and row of the first cell of each object, as nibbles
+    uint8_t objectFirstCell[maxObjects];
+};
+
+#endif
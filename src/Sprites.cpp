@@ -5,6 +5,30 @@
  */
 
 #include "Sprites.h"
+#include "SpritesT.h"
+
+// Get the width and height of a sprite and move the image and mask
+// pointers to the start of the frames to be drawn
+static void frameStart(const uint8_t *&bitmap, uint8_t frame,
+                       const uint8_t *&mask, uint8_t mask_frame,
+                       uint8_t drawMode, uint8_t &width, uint8_t &height)
+{
+  unsigned int frame_offset;
+
+  width = pgm_read_byte(bitmap);
+  height = pgm_read_byte(++bitmap);
+  bitmap++;
+  if (frame > 0 || mask_frame > 0) {
+    frame_offset = (width * ( height / 8 + ( height % 8 == 0 ? 0 : 1)));
+    // sprite plus mask uses twice as much space for each frame
+    if (drawMode == SPRITE_PLUS_MASK) {
+      frame_offset *= 2;
+    } else if (mask != NULL) {
+      mask += mask_frame * frame_offset;
+    }
+    bitmap += frame * frame_offset;
+  }
+}
 
 void Sprites::drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
                                const uint8_t *mask, uint8_t frame, uint8_t mask_frame)
@@ -32,6 +56,69 @@ void Sprites::drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t
   draw(x, y, bitmap, frame, NULL, 0, SPRITE_PLUS_MASK);
 }
 
+// The scaled functions don't use draw(), so the scaling code is only linked
+// into sketches that use it
+static void drawFrameScaled(int16_t x, int16_t y,
+                            const uint8_t *bitmap, uint8_t frame,
+                            const uint8_t *mask, uint8_t mask_frame,
+                            uint8_t drawMode, uint8_t scale)
+{
+  uint8_t width, height;
+
+  if (bitmap == NULL)
+    return;
+
+  frameStart(bitmap, frame, mask, mask_frame, drawMode, width, height);
+
+  if (scale == 2 || scale == 4) {
+    Sprites::drawBitmapScaled(x, y, bitmap, mask, width, height, drawMode, scale);
+  } else {
+    Sprites::drawBitmap(x, y, bitmap, mask, width, height, drawMode);
+  }
+}
+
+void Sprites::drawScaled(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                         uint8_t scale, uint8_t drawMode)
+{
+  drawFrameScaled(x, y, bitmap, frame, NULL, 0, drawMode, scale);
+}
+
+void Sprites::drawExternalMaskScaled(int16_t x, int16_t y, const uint8_t *bitmap,
+                                     const uint8_t *mask, uint8_t frame,
+                                     uint8_t mask_frame, uint8_t scale)
+{
+  drawFrameScaled(x, y, bitmap, frame, mask, mask_frame, SPRITE_MASKED, scale);
+}
+
+// The RAM functions use the loops of SpritesT, reading with ordinary loads
+
+void Sprites::drawExternalMaskRAM(int16_t x, int16_t y, const uint8_t *bitmap,
+                                  const uint8_t *mask, uint8_t frame, uint8_t mask_frame)
+{
+  SpritesT<SPRITE_MASKED, 0, 0, false>::drawExternalMask(x, y, bitmap, mask,
+                                                         frame, mask_frame);
+}
+
+void Sprites::drawPlusMaskRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+  SpritesT<SPRITE_PLUS_MASK, 0, 0, false>::draw(x, y, bitmap, frame);
+}
+
+void Sprites::drawOverwriteRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+  SpritesT<SPRITE_OVERWRITE, 0, 0, false>::draw(x, y, bitmap, frame);
+}
+
+void Sprites::drawEraseRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+  SpritesT<SPRITE_IS_MASK_ERASE, 0, 0, false>::draw(x, y, bitmap, frame);
+}
+
+void Sprites::drawSelfMaskedRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+  SpritesT<SPRITE_IS_MASK, 0, 0, false>::draw(x, y, bitmap, frame);
+}
+
 
 //common functions
 void Sprites::draw(int16_t x, int16_t y,
@@ -39,24 +126,12 @@ void Sprites::draw(int16_t x, int16_t y,
                    const uint8_t *mask, uint8_t sprite_frame,
                    uint8_t drawMode)
 {
-  unsigned int frame_offset;
+  uint8_t width, height;
 
   if (bitmap == NULL)
     return;
 
-  uint8_t width = pgm_read_byte(bitmap);
-  uint8_t height = pgm_read_byte(++bitmap);
-  bitmap++;
-  if (frame > 0 || sprite_frame > 0) {
-    frame_offset = (width * ( height / 8 + ( height % 8 == 0 ? 0 : 1)));
-    // sprite plus mask uses twice as much space for each frame
-    if (drawMode == SPRITE_PLUS_MASK) {
-      frame_offset *= 2;
-    } else if (mask != NULL) {
-      mask += sprite_frame * frame_offset;
-    }
-    bitmap += frame * frame_offset;
-  }
+  frameStart(bitmap, frame, mask, sprite_frame, drawMode, width, height);
 
   // if we're detecting the draw mode then base it on whether a mask
   // was passed as a separate object
@@ -72,12 +147,32 @@ void Sprites::drawBitmap(int16_t x, int16_t y,
                          uint8_t w, uint8_t h, uint8_t draw_mode)
 {
   // no need to draw at all of we're offscreen
-  if (x + w <= 0 || x > WIDTH - 1 || y + h <= 0 || y > HEIGHT - 1)
+  if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
     return;
 
   if (bitmap == NULL)
     return;
 
+  #ifdef CLIP_RECT_MODE
+  // The code below only clips to the screen edges. A sprite that crosses
+  // an edge of the clip rectangle inside the screen is drawn by SpritesB,
+  // which masks each page to the clip rectangle. Whole pages are written,
+  // so the height is rounded up.
+  if ((x < CLIP_LEFT && CLIP_LEFT != 0) ||
+      (x + w > CLIP_RIGHT && CLIP_RIGHT != WIDTH) ||
+      (y < CLIP_TOP && CLIP_TOP != 0) ||
+      (y + ((h + 7) & ~7) > CLIP_BOTTOM && CLIP_BOTTOM != HEIGHT)) {
+    SpritesB::drawBitmap(x, y, bitmap, mask, w, h, draw_mode);
+    return;
+  }
+  #endif
+
+  #ifdef DIRTY_TRACKING_MODE
+  // the sprite is drawn in whole pages, so round the height up
+  Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
   // xOffset technically doesn't need to be 16 bit but the math operations
   // are measurably faster if it is
   uint16_t xOffset, ofs;
@@ -126,6 +221,14 @@ void Sprites::drawBitmap(int16_t x, int16_t y,
   uint8_t *bofs = (uint8_t *)bitmap + (start_h * w) + xOffset;
   uint8_t data;
 
+  // A sprite on a page boundary covers whole pages, so each byte can be
+  // copied or masked straight into the buffer without being shifted
+  if (yOffset == 0) {
+    drawAligned(sRow, ofs, bitmap, mask, w, start_h, xOffset,
+                loop_h, rendered_width, draw_mode);
+    return;
+  }
+
   uint8_t mul_amt = 1 << yOffset;
   uint16_t mask_data;
   uint16_t bitmap_data;
@@ -135,8 +238,6 @@ void Sprites::drawBitmap(int16_t x, int16_t y,
       // we only want to mask the 8 bits of our own sprite, so we can
       // calculate the mask before the start of the loop
       mask_data = ~(0xFF * mul_amt);
-      // really if yOffset = 0 you have a faster case here that could be
-      // optimized
       for (uint8_t a = 0; a < loop_h; a++) {
         for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
           bitmap_data = pgm_read_byte(bofs) * mul_amt;
@@ -358,3 +459,866 @@ void Sprites::drawBitmap(int16_t x, int16_t y,
       break;
   }
 }
+
+void Sprites::drawAligned(int8_t sRow, uint16_t ofs,
+                          const uint8_t *bitmap, const uint8_t *mask,
+                          uint8_t w, uint8_t start_h, uint8_t xOffset,
+                          uint8_t loop_h, uint8_t rendered_width,
+                          uint8_t draw_mode)
+{
+  // bytes per column of the source
+  const uint8_t ofs_step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  const uint8_t *bofs = bitmap + ((start_h * w) + xOffset) * ofs_step;
+  const uint8_t *mask_ofs = mask + (start_h * w) + xOffset;
+  const uint16_t bofs_jump = (w - rendered_width) * ofs_step;
+  const uint8_t mask_jump = w - rendered_width;
+  const uint8_t buffer_jump = WIDTH - rendered_width;
+
+  // the page above the screen is all that's left of the part of the sprite
+  // above it, so it's skipped
+  if (sRow < 0) {
+    bofs += w * ofs_step;
+    mask_ofs += w;
+    ofs += WIDTH;
+    loop_h--;
+  }
+
+  uint8_t *buf = Arduboy2Base::sBuffer + ofs;
+  uint8_t data;
+
+  switch (draw_mode) {
+    case SPRITE_UNMASKED:
+      for (uint8_t a = loop_h; a != 0; a--) {
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          *buf++ = pgm_read_byte(bofs++);
+        }
+        bofs += bofs_jump;
+        buf += buffer_jump;
+      }
+      break;
+
+    case SPRITE_IS_MASK:
+      for (uint8_t a = loop_h; a != 0; a--) {
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          *buf++ |= pgm_read_byte(bofs++);
+        }
+        bofs += bofs_jump;
+        buf += buffer_jump;
+      }
+      break;
+
+    case SPRITE_IS_MASK_ERASE:
+      for (uint8_t a = loop_h; a != 0; a--) {
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          *buf++ &= ~pgm_read_byte(bofs++);
+        }
+        bofs += bofs_jump;
+        buf += buffer_jump;
+      }
+      break;
+
+    case SPRITE_MASKED:
+      for (uint8_t a = loop_h; a != 0; a--) {
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          data = *buf & ~pgm_read_byte(mask_ofs++);
+          *buf++ = data | pgm_read_byte(bofs++);
+        }
+        bofs += bofs_jump;
+        mask_ofs += mask_jump;
+        buf += buffer_jump;
+      }
+      break;
+
+    case SPRITE_PLUS_MASK:
+      for (uint8_t a = loop_h; a != 0; a--) {
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          data = pgm_read_byte(bofs++);
+          *buf = (*buf & ~pgm_read_byte(bofs++)) | data;
+          buf++;
+        }
+        bofs += bofs_jump;
+        buf += buffer_jump;
+      }
+      break;
+  }
+}
+
+// The mirrored versions are kept apart, so the mirroring code is only linked
+// into sketches that use it
+
+void Sprites::drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
+                               const uint8_t *mask, uint8_t frame, uint8_t mask_frame,
+                               uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, mask, mask_frame, SPRITE_MASKED, mirror);
+}
+
+void Sprites::drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                            uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_OVERWRITE, mirror);
+}
+
+void Sprites::drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                        uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_IS_MASK_ERASE, mirror);
+}
+
+void Sprites::drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                             uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_IS_MASK, mirror);
+}
+
+void Sprites::drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                           uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_PLUS_MASK, mirror);
+}
+
+void Sprites::drawMirrored(int16_t x, int16_t y,
+                           const uint8_t *bitmap, uint8_t frame,
+                           const uint8_t *mask, uint8_t sprite_frame,
+                           uint8_t drawMode, uint8_t mirror)
+{
+  uint8_t width, height;
+
+  if (bitmap == NULL)
+    return;
+
+  frameStart(bitmap, frame, mask, sprite_frame, drawMode, width, height);
+
+  drawBitmapMirrored(x, y, bitmap, mask, width, height, drawMode, mirror);
+}
+
+// the bits of each byte value in reverse order, for vertical mirroring
+static const uint8_t reversedBits[256] PROGMEM = {
+  0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
+  0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8, 0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
+  0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
+  0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
+  0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2, 0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
+  0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
+  0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6, 0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
+  0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE, 0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
+  0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1, 0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
+  0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9, 0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
+  0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5, 0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
+  0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED, 0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
+  0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3, 0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
+  0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB, 0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
+  0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7, 0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
+  0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF, 0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF,
+};
+
+void Sprites::drawBitmapMirrored(int16_t x, int16_t y,
+                                 const uint8_t *bitmap, const uint8_t *mask,
+                                 uint8_t w, uint8_t h, uint8_t draw_mode,
+                                 uint8_t mirror)
+{
+  // no need to draw at all if we're offscreen
+  if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
+    return;
+
+  if (bitmap == NULL)
+    return;
+
+  // A vertical flip reverses whole pages, which puts the unused rows at the
+  // bottom of the last page above the sprite. It's drawn that much higher,
+  // so the sprite's own rows stay in place.
+  const uint8_t pad = (mirror & MIRROR_VERTICAL) ? ((h + 7) & ~7) - h : 0;
+
+  #ifdef CLIP_RECT_MODE
+  // clipped to an edge of the clip rectangle inside the screen by SpritesB,
+  // as for drawBitmap()
+  if ((x < CLIP_LEFT && CLIP_LEFT != 0) ||
+      (x + w > CLIP_RIGHT && CLIP_RIGHT != WIDTH) ||
+      (y - pad < CLIP_TOP && CLIP_TOP != 0) ||
+      (y - pad + ((h + 7) & ~7) > CLIP_BOTTOM && CLIP_BOTTOM != HEIGHT)) {
+    SpritesB::drawBitmapMirrored(x, y, bitmap, mask, w, h, draw_mode, mirror);
+    return;
+  }
+  #endif
+
+  y -= pad;
+
+  #ifdef DIRTY_TRACKING_MODE
+  // the sprite is drawn in whole pages, so round the height up
+  Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
+  // clipped the same as for drawBitmap()
+  uint16_t xOffset;
+  int16_t ofs;
+  int8_t yOffset = y & 7;
+  int8_t sRow = y / 8;
+  uint8_t loop_h, start_h, rendered_width;
+
+  if (y < 0 && yOffset > 0) {
+    sRow--;
+  }
+
+  xOffset = (x < 0) ? -x : 0;
+  if (x + w > WIDTH - 1) {
+    rendered_width = (WIDTH - x) - xOffset;
+  } else {
+    rendered_width = w - xOffset;
+  }
+  start_h = (sRow < -1) ? -sRow - 1 : 0;
+
+  const uint8_t pages = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
+  loop_h = pages;
+  if (sRow + loop_h > (HEIGHT / 8)) {
+    loop_h = (HEIGHT / 8) - sRow;
+  }
+  loop_h -= start_h;
+  sRow += start_h;
+  ofs = (sRow * WIDTH) + x + xOffset;
+
+  // The data is read from the other end of each row for a horizontal flip,
+  // and from the last row up for a vertical flip, with the bits of each
+  // byte reversed
+  const uint8_t ofs_step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  uint8_t src_col = xOffset;
+  uint8_t src_row = start_h;
+  int8_t col_step = ofs_step;
+  int16_t row_step = w * ofs_step;
+
+  if (mirror & MIRROR_HORIZONTAL) {
+    src_col = w - 1 - xOffset;
+    col_step = -col_step;
+  }
+  if (mirror & MIRROR_VERTICAL) {
+    src_row = pages - 1 - start_h;
+    row_step = -row_step;
+  }
+
+  const int16_t ofs_stride = row_step - (rendered_width * col_step);
+  const uint16_t initial_bofs = ((src_row * w) + src_col) * ofs_step;
+  const uint8_t *bofs = bitmap + initial_bofs;
+  const uint8_t *mask_ofs = (draw_mode == SPRITE_MASKED) ?
+                            mask + initial_bofs : bofs + 1;
+  const bool has_mask = (draw_mode == SPRITE_MASKED) ||
+                        (draw_mode == SPRITE_PLUS_MASK);
+  const bool flip = mirror & MIRROR_VERTICAL;
+  const uint8_t mul_amt = 1 << yOffset;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
+      uint8_t image = pgm_read_byte(bofs);
+      uint8_t mask_byte;
+
+      if (flip) {
+        image = pgm_read_byte(reversedBits + image);
+      }
+
+      // the pixels the sprite changes
+      if (has_mask) {
+        mask_byte = pgm_read_byte(mask_ofs);
+        if (flip) {
+          mask_byte = pgm_read_byte(reversedBits + mask_byte);
+        }
+      } else if (draw_mode == SPRITE_UNMASKED) {
+        mask_byte = 0xFF;
+      } else {
+        mask_byte = image;
+        if (draw_mode == SPRITE_IS_MASK_ERASE) {
+          image = 0;
+        }
+      }
+
+      uint16_t bitmap_data = image * mul_amt;
+      uint16_t mask_data = mask_byte * mul_amt;
+      uint8_t *buf = Arduboy2Base::sBuffer + ofs;
+
+      if (sRow >= 0) {
+        *buf = (*buf & ~(uint8_t)mask_data) | (uint8_t)bitmap_data;
+      }
+      if (yOffset != 0 && sRow < 7) {
+        buf[WIDTH] = (buf[WIDTH] & ~(uint8_t)(mask_data >> 8)) |
+                     (uint8_t)(bitmap_data >> 8);
+      }
+      ofs++;
+      bofs += col_step;
+      mask_ofs += col_step;
+    }
+    sRow++;
+    bofs += ofs_stride;
+    mask_ofs += ofs_stride;
+    ofs += WIDTH - rendered_width;
+  }
+}
+
+void Sprites::drawBitmapScaled(int16_t x, int16_t y,
+                               const uint8_t *bitmap, const uint8_t *mask,
+                               uint8_t w, uint8_t h, uint8_t draw_mode,
+                               uint8_t scale)
+{
+  const uint8_t shift = scale >> 1; // 1 or 2
+  const uint8_t rows = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
+  // the scaled width and height. Whole pages are drawn, so the height is
+  // rounded up.
+  const int16_t sw = w << shift;
+  const int16_t sh = (rows * 8) << shift;
+
+  // no need to draw at all if we're offscreen
+  if (x + sw <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + sh <= CLIP_TOP || y > CLIP_BOTTOM - 1)
+    return;
+
+  if (bitmap == NULL)
+    return;
+
+  #ifdef DIRTY_TRACKING_MODE
+  Arduboy2Base::markDirty(x, y, sw, sh);
+  #endif
+
+  int8_t yOffset = y & 7;
+  int16_t sRow = y / 8;
+
+  if (y < 0 && yOffset > 0) {
+    sRow--;
+  }
+
+  // The visible columns and pages of the scaled sprite. Only whole bytes
+  // are clipped, so the scaled bytes are never shifted into each other.
+  int16_t colStart = (x < CLIP_LEFT) ? CLIP_LEFT - x : 0;
+  int16_t colEnd = (x + sw > CLIP_RIGHT) ? CLIP_RIGHT - x : sw;
+  int16_t pageStart = (CLIP_TOP / 8) - sRow - (yOffset != 0);
+  int16_t pageEnd = ((CLIP_BOTTOM - 1) / 8) + 1 - sRow;
+  if (pageStart < 0) {
+    pageStart = 0;
+  }
+  if (pageEnd > (rows << shift)) {
+    pageEnd = rows << shift;
+  }
+
+  const uint8_t ofs_step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  const bool has_mask = (draw_mode == SPRITE_MASKED) ||
+                        (draw_mode == SPRITE_PLUS_MASK);
+  const uint8_t mul_amt = 1 << yOffset;
+
+  // Each page of the scaled sprite is one part of a row of the sprite.
+  // Its image and mask bytes are made once for each column of the sprite
+  // and written to the scale columns of the buffer that it covers.
+  for (int16_t a = pageStart; a < pageEnd; a++) {
+    int16_t bRow = sRow + a;
+    uint16_t row_ofs = (a >> shift) * w;
+    const uint8_t *bofs = bitmap + (row_ofs * ofs_step);
+    const uint8_t *mask_ofs = (draw_mode == SPRITE_MASKED) ?
+                              mask + row_ofs : bofs + 1;
+    uint8_t part = a & (scale - 1);
+    uint8_t *buf = Arduboy2Base::sBuffer + (bRow * WIDTH) + x;
+
+    // the rows of the two pages that can be drawn on
+    uint16_t clip;
+    #ifdef CLIP_RECT_MODE
+    clip = Arduboy2Base::clipPageMask(bRow) |
+           (Arduboy2Base::clipPageMask(bRow + 1) << 8);
+    #else
+    clip = ((bRow >= 0) ? 0x00FF : 0) |
+           ((bRow < (HEIGHT / 8) - 1) ? 0xFF00 : 0);
+    #endif
+
+    uint16_t bitmap_data = 0;
+    uint16_t mask_data = 0;
+
+    for (int16_t iCol = colStart; iCol < colEnd; iCol++) {
+      if (iCol == colStart || (iCol & (scale - 1)) == 0) {
+        uint8_t sCol = iCol >> shift;
+        uint8_t image = Arduboy2Base::scaleBits(pgm_read_byte(bofs + (sCol * ofs_step)),
+                                                shift, part);
+        uint8_t mask_byte;
+
+        // The pixels the sprite clears before the image bits are inverted.
+        // The image bits are included, so they're set.
+        if (has_mask) {
+          mask_byte = Arduboy2Base::scaleBits(pgm_read_byte(mask_ofs + (sCol * ofs_step)),
+                                              shift, part) | image;
+        } else if (draw_mode == SPRITE_UNMASKED) {
+          mask_byte = 0xFF;
+        } else if (draw_mode == SPRITE_IS_MASK_INVERT) {
+          mask_byte = 0;
+        } else {
+          mask_byte = image;
+          if (draw_mode == SPRITE_IS_MASK_ERASE) {
+            image = 0;
+          }
+        }
+
+        bitmap_data = (image * mul_amt) & clip;
+        mask_data = (mask_byte * mul_amt) & clip;
+      }
+
+      // bytes with no bits to change (including any off the screen) are
+      // skipped
+      if ((uint8_t)(mask_data | bitmap_data) != 0) {
+        buf[iCol] = (buf[iCol] & ~(uint8_t)mask_data) ^ (uint8_t)bitmap_data;
+      }
+      if (((mask_data | bitmap_data) >> 8) != 0) {
+        buf[iCol + WIDTH] = (buf[iCol + WIDTH] & ~(uint8_t)(mask_data >> 8)) ^
+                            (uint8_t)(bitmap_data >> 8);
+      }
+    }
+  }
+}
+
+
+// Helper for drawPacked(). Decodes the byte stream of one packed frame.
+struct PackedReader
+{
+  const uint8_t *code; // the next code to be read
+  const uint8_t *data; // the next byte of a literal or copy
+  uint8_t left;        // bytes left from the current code
+  uint8_t value;       // the byte being repeated
+  bool repeat;
+
+  PackedReader(const uint8_t *stream)
+    : code(stream), data(), left(0), value(), repeat()
+  {
+  }
+
+  void nextCode()
+  {
+    uint8_t c = pgm_read_byte(code++);
+
+    if (c < 0x80) { // literal
+      left = c + 1;
+      repeat = false;
+      data = code;
+      code += left;
+    }
+    else if (c < 0xC0) { // run
+      left = (c & 0x3F) + 2;
+      repeat = true;
+      value = pgm_read_byte(code++);
+    }
+    else { // copy
+      left = (c & 0x3F) + 3;
+      repeat = false;
+      data = (code - 1) - pgm_read_word(code);
+      code += 2;
+    }
+  }
+
+  uint8_t read()
+  {
+    if (left == 0) {
+      nextCode();
+    }
+    left--;
+    return repeat ? value : pgm_read_byte(data++);
+  }
+
+  // skip bytes a whole code at a time when possible
+  void skip(uint16_t count)
+  {
+    while (count != 0) {
+      if (left == 0) {
+        nextCode();
+      }
+      uint8_t n = count < left ? count : left;
+      left -= n;
+      count -= n;
+      if (!repeat) {
+        data += n;
+      }
+    }
+  }
+};
+
+// get the start of the data for a frame of a packed sprite
+static const uint8_t *packedFrame(const uint8_t *sprite, uint8_t frame, bool mask)
+{
+  uint16_t entry = frame;
+
+  if (pgm_read_byte(sprite + 3) & 0x01) { // has masks
+    entry = (entry * 2) + mask;
+  }
+  return sprite + pgm_read_word(sprite + 4 + (entry * 2));
+}
+
+void Sprites::drawPackedExternalMask(int16_t x, int16_t y,
+                                     const uint8_t *sprite, const uint8_t *mask,
+                                     uint8_t frame, uint8_t mask_frame)
+{
+  drawPacked(x, y, sprite, frame, mask, mask_frame, SPRITE_MASKED);
+}
+
+void Sprites::drawPackedPlusMask(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPacked(x, y, sprite, frame, sprite, frame, SPRITE_PLUS_MASK);
+}
+
+void Sprites::drawPackedOverwrite(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPacked(x, y, sprite, frame, NULL, 0, SPRITE_OVERWRITE);
+}
+
+void Sprites::drawPackedErase(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPacked(x, y, sprite, frame, NULL, 0, SPRITE_IS_MASK_ERASE);
+}
+
+void Sprites::drawPackedSelfMasked(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPacked(x, y, sprite, frame, NULL, 0, SPRITE_IS_MASK);
+}
+
+void Sprites::drawPacked(int16_t x, int16_t y,
+                         const uint8_t *sprite, uint8_t frame,
+                         const uint8_t *mask, uint8_t mask_frame,
+                         uint8_t drawMode)
+{
+  if (sprite == NULL)
+    return;
+
+  uint8_t w = pgm_read_byte(sprite);
+  uint8_t h = pgm_read_byte(sprite + 1);
+
+  // no need to draw at all if we're offscreen
+  if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
+    return;
+
+  #ifdef DIRTY_TRACKING_MODE
+  // the sprite is drawn in whole pages, so round the height up
+  Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
+  PackedReader image(packedFrame(sprite, frame, false));
+  // only used for SPRITE_MASKED and SPRITE_PLUS_MASK
+  PackedReader maskReader(mask == NULL ? NULL :
+                          packedFrame(mask, mask_frame, drawMode == SPRITE_PLUS_MASK));
+
+  int8_t yOffset = y & 7;
+  int8_t sRow = y / 8;
+  uint8_t xOffset, loop_h, start_h, rendered_width;
+
+  if (y < 0 && yOffset > 0) {
+    sRow--;
+  }
+
+  // the first and last pages (8 pixel high rows) that can be drawn on
+  const int8_t firstPage = CLIP_TOP / 8;
+  const int8_t lastPage = (CLIP_BOTTOM - 1) / 8;
+
+  // if the left side of the render is offscreen skip those bytes
+  xOffset = x < CLIP_LEFT ? CLIP_LEFT - x : 0;
+
+  // if the right side of the render is offscreen skip those bytes
+  if (x + w > CLIP_RIGHT) {
+    rendered_width = (CLIP_RIGHT - x) - xOffset;
+  } else {
+    rendered_width = w - xOffset;
+  }
+
+  // bytes skipped at the end of each row
+  uint8_t xSkip = w - xOffset - rendered_width;
+
+  // if the top side of the render is offscreen skip those rows
+  start_h = sRow < firstPage - 1 ? firstPage - 1 - sRow : 0;
+
+  loop_h = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
+  if (sRow + loop_h > lastPage + 1) {
+    loop_h = lastPage + 1 - sRow;
+  }
+  loop_h -= start_h;
+  sRow += start_h;
+
+  image.skip(start_h * w);
+  maskReader.skip(mask == NULL ? 0 : start_h * w);
+
+  // sRow can be -1 here, but the buffer is only accessed at this position
+  // when sRow >= 0
+  uint8_t *buf = Arduboy2Base::sBuffer + (sRow * WIDTH) + x + xOffset;
+  uint8_t mul_amt = 1 << yOffset;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    image.skip(xOffset);
+    if (mask != NULL) {
+      maskReader.skip(xOffset);
+    }
+
+    #ifdef CLIP_RECT_MODE
+    // the rows of the two pages inside the clip rectangle
+    uint16_t clip = Arduboy2Base::clipPageMask(sRow) |
+                    (Arduboy2Base::clipPageMask(sRow + 1) << 8);
+    #endif
+
+    for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
+      uint8_t bitmap_byte = image.read();
+      uint8_t mask_byte;
+
+      switch (drawMode) {
+        case SPRITE_OVERWRITE:
+          mask_byte = 0xFF;
+          break;
+        case SPRITE_IS_MASK:
+          mask_byte = 0;
+          break;
+        case SPRITE_IS_MASK_ERASE:
+          mask_byte = bitmap_byte;
+          bitmap_byte = 0;
+          break;
+        default:
+          mask_byte = maskReader.read();
+      }
+
+      uint16_t bitmap_data = bitmap_byte * mul_amt;
+      uint16_t mask_data = mask_byte * mul_amt;
+
+      #ifdef CLIP_RECT_MODE
+      bitmap_data &= clip;
+      mask_data &= clip;
+      #endif
+
+      if (sRow >= firstPage) {
+        *buf = (*buf & ~(uint8_t)mask_data) | (uint8_t)bitmap_data;
+      }
+      if (yOffset != 0 && sRow < lastPage) {
+        buf[WIDTH] = (buf[WIDTH] & ~(uint8_t)(mask_data >> 8)) |
+                     (uint8_t)(bitmap_data >> 8);
+      }
+      buf++;
+    }
+
+    image.skip(xSkip);
+    if (mask != NULL) {
+      maskReader.skip(xSkip);
+    }
+    sRow++;
+    buf += WIDTH - rendered_width;
+  }
+}
+
+void Sprites::drawTilemap(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                          const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight)
+{
+  drawTiles(scrollX, scrollY, tileset, map, mapWidth, mapHeight, false);
+}
+
+void Sprites::drawTilemap_P(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                            const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight)
+{
+  drawTiles(scrollX, scrollY, tileset, map, mapWidth, mapHeight, true);
+}
+
+void Sprites::drawTiles(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                        const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight,
+                        bool mapInProgmem)
+{
+  uint8_t tileSize = pgm_read_byte(tileset);
+  uint8_t tileShift = (tileSize == 16) ? 4 : 3;
+  uint8_t tileBytes = tileSize * (tileSize / 8);
+  uint8_t colMask = tileSize - 1;
+  tileset += 2;
+
+  // clip the map to the screen, once for the whole map
+  int16_t mapPixelHeight = mapHeight << tileShift;
+  int16_t xStart = scrollX < 0 ? -scrollX : 0;
+  int16_t yStart = scrollY < 0 ? -scrollY : 0;
+  int16_t xEnd = (mapWidth << tileShift) - scrollX;
+  int16_t yEnd = mapPixelHeight - scrollY;
+
+  if (xStart < CLIP_LEFT)
+    xStart = CLIP_LEFT;
+  if (yStart < CLIP_TOP)
+    yStart = CLIP_TOP;
+  if (xEnd > CLIP_RIGHT)
+    xEnd = CLIP_RIGHT;
+  if (yEnd > CLIP_BOTTOM)
+    yEnd = CLIP_BOTTOM;
+  if (xStart >= xEnd || yStart >= yEnd)
+    return;
+
+  #ifdef DIRTY_TRACKING_MODE
+  Arduboy2Base::markDirty(xStart, yStart, xEnd - xStart, yEnd - yStart);
+  #endif
+
+  uint8_t yOffset = scrollY & 7;
+  uint8_t lastPage = (yEnd - 1) / 8;
+  uint8_t mapX = (scrollX + xStart) >> tileShift;
+  uint8_t firstCol = (scrollX + xStart) & colMask;
+
+  for (uint8_t page = yStart / 8; page <= lastPage; page++)
+  {
+    // the bits of this page that are within the map
+    uint8_t mask = 0xFF;
+    if (page == yStart / 8)
+      mask = 0xFF << (yStart & 7);
+    if (page == lastPage)
+      mask &= 0xFF >> (7 - ((yEnd - 1) & 7));
+
+    // Map pixel rows of the tile bytes that make up this page. Byte A gives
+    // the top of the page and, when not page aligned, byte B the bottom.
+    int16_t rowA = scrollY + (page * 8) - yOffset;
+    int16_t rowB = rowA + 8;
+    // A row outside the map only supplies bits that are masked off,
+    // so the other row can be used in its place
+    if (rowA < 0)
+      rowA = rowB;
+    if (rowB >= mapPixelHeight)
+      rowB = rowA;
+
+    const uint8_t *mapA = map + (uint16_t)(rowA >> tileShift) * mapWidth + mapX;
+    const uint8_t *mapB = map + (uint16_t)(rowB >> tileShift) * mapWidth + mapX;
+    uint8_t pageOfsA = ((rowA & colMask) >> 3) * tileSize;
+    uint8_t pageOfsB = ((rowB & colMask) >> 3) * tileSize;
+
+    uint8_t *dst = Arduboy2Base::sBuffer + (page * WIDTH) + xStart;
+    uint8_t col = firstCol;
+    uint8_t left = xEnd - xStart;
+
+    while (left != 0)
+    {
+      uint8_t n = tileSize - col;
+      if (n > left)
+        n = left;
+
+      uint8_t tileA = mapInProgmem ? pgm_read_byte(mapA) : *mapA;
+      const uint8_t *srcA = tileset + (tileA * tileBytes) + pageOfsA + col;
+      mapA++;
+
+      if (yOffset == 0)
+      {
+        // page aligned: tile bytes are copied straight to the buffer
+        if (mask == 0xFF)
+        {
+          memcpy_P(dst, srcA, n);
+          dst += n;
+        }
+        else
+        {
+          for (uint8_t i = n; i != 0; i--)
+          {
+            *dst = (*dst & ~mask) | (pgm_read_byte(srcA++) & mask);
+            dst++;
+          }
+        }
+      }
+      else
+      {
+        uint8_t tileB = mapInProgmem ? pgm_read_byte(mapB) : *mapB;
+        const uint8_t *srcB = tileset + (tileB * tileBytes) + pageOfsB + col;
+
+        for (uint8_t i = n; i != 0; i--)
+        {
+          uint8_t data = (pgm_read_byte(srcA++) >> yOffset) |
+                         (pgm_read_byte(srcB++) << (8 - yOffset));
+          *dst = (*dst & ~mask) | (data & mask);
+          dst++;
+        }
+      }
+      mapB++;
+
+      left -= n;
+      col = 0;
+    }
+  }
+}
+
+// Get the mask bytes of a frame that collide() uses as the sprite's shape.
+// Returns a pointer to the first one and sets the distance between them.
+static const uint8_t *spriteShape(const uint8_t *bitmap, uint8_t frame,
+                                  const uint8_t *mask, uint8_t drawMode,
+                                  uint8_t *step)
+{
+  uint8_t h = pgm_read_byte(bitmap + 1);
+  uint16_t frame_size = pgm_read_byte(bitmap) * (h / 8 + (h % 8 > 0 ? 1 : 0));
+  bitmap += 2;
+
+  if (drawMode == SPRITE_PLUS_MASK) {
+    // the mask byte follows each image byte
+    *step = 2;
+    return bitmap + (frame * frame_size * 2) + 1;
+  }
+
+  *step = 1;
+  if (mask != NULL) {
+    return mask + (frame * frame_size);
+  }
+  return bitmap + (frame * frame_size);
+}
+
+bool Sprites::collide(int16_t x1, int16_t y1, const uint8_t *bitmap1, uint8_t frame1,
+                      int16_t x2, int16_t y2, const uint8_t *bitmap2, uint8_t frame2,
+                      const uint8_t *mask1, const uint8_t *mask2,
+                      uint8_t drawMode1, uint8_t drawMode2)
+{
+  if (bitmap1 == NULL || bitmap2 == NULL)
+    return false;
+
+  const uint8_t w1 = pgm_read_byte(bitmap1);
+  const uint8_t h1 = pgm_read_byte(bitmap1 + 1);
+  const uint8_t w2 = pgm_read_byte(bitmap2);
+  const uint8_t h2 = pgm_read_byte(bitmap2 + 1);
+
+  // the area where the rectangles of the two sprites overlap
+  const int16_t left = (x1 > x2) ? x1 : x2;
+  const int16_t right = (x1 + w1 < x2 + w2) ? x1 + w1 : x2 + w2;
+  const int16_t top = (y1 > y2) ? y1 : y2;
+  const int16_t bottom = (y1 + h1 < y2 + h2) ? y1 + h1 : y2 + h2;
+
+  if (left >= right || top >= bottom)
+    return false;
+
+  uint8_t step1, step2;
+  const uint8_t *shape1 = spriteShape(bitmap1, frame1, mask1, drawMode1, &step1);
+  const uint8_t *shape2 = spriteShape(bitmap2, frame2, mask2, drawMode2, &step2);
+
+  const uint8_t pages2 = h2 / 8 + (h2 % 8 > 0 ? 1 : 0); // divide, then round up
+  const uint8_t width = right - left;
+  const uint8_t lastPage = (bottom - 1 - y1) / 8;
+
+  // Go through the pages of the first sprite that are in the overlap area.
+  // Each column of a page is tested against the two pages of the second
+  // sprite that it covers, shifted to line up with it.
+  for (uint8_t page = (top - y1) / 8; page <= lastPage; page++) {
+    const int16_t pageTop = y1 + (page * 8);
+
+    // the rows of the page inside the overlap area
+    uint8_t rowMask = 0xFF;
+    if (top > pageTop) {
+      rowMask <<= top - pageTop;
+    }
+    if (bottom < pageTop + 8) {
+      rowMask &= 0xFF >> (pageTop + 8 - bottom);
+    }
+
+    // The page of the second sprite at the top of this page, and the number
+    // of rows down it is. It's -1 when the second sprite starts part way
+    // down this page.
+    const int16_t dy = pageTop - y2;
+    const int8_t page2 = (dy < 0) ? -1 : dy / 8;
+    const uint8_t shift = dy & 7;
+    const bool upperPage = page2 >= 0;
+    const bool lowerPage = page2 + 1 < pages2;
+
+    const uint8_t *ofs1 = shape1 + ((page * w1) + (left - x1)) * step1;
+    const uint8_t *ofs2 = shape2 + ((page2 * w2) + (left - x2)) * step2;
+
+    for (uint8_t i = width; i != 0; i--) {
+      uint8_t bits = pgm_read_byte(ofs1) & rowMask;
+
+      if (bits != 0) {
+        uint16_t other = 0;
+        if (upperPage) {
+          other = pgm_read_byte(ofs2);
+        }
+        if (lowerPage) {
+          other |= pgm_read_byte(ofs2 + (w2 * step2)) << 8;
+        }
+        if (bits & (other >> shift)) {
+          return true;
+        }
+      }
+      ofs1 += step1;
+      ofs2 += step2;
+    }
+  }
+
+  return false;
+}
@@ -43,6 +43,61 @@
  * Data for each frame after the first one immediately follows the previous
  * frame. Frame numbers start at 0.
  *
+ * \par Mirrored sprites
+ * \parblock
+ * The `drawOverwrite()`, `drawErase()`, `drawSelfMasked()`, `drawPlusMask()`
+ * and `drawExternalMask()` functions each have a second version that takes
+ * a `mirror` parameter. Passing `MIRROR_HORIZONTAL` draws the sprite flipped left to right, and
+ * `MIRROR_VERTICAL` draws it flipped top to bottom. Both can be given, as
+ * `MIRROR_HORIZONTAL | MIRROR_VERTICAL`, to rotate the sprite by 180 degrees.
+ * This lets, for example, one set of frames be used for a character facing
+ * either way. The mask is flipped along with the image.
+ *
+ * The mirrored versions are separate functions, so the code for mirroring
+ * only takes up program space in sketches that use them.
+ * \endparblock
+ *
+ * \par Sprites in RAM
+ * \parblock
+ * The `drawOverwriteRAM()`, `drawEraseRAM()`, `drawSelfMaskedRAM()`,
+ * `drawPlusMaskRAM()` and `drawExternalMaskRAM()` functions draw sprites
+ * from arrays in RAM instead of program memory. The arrays are in the same
+ * format. This allows sprites that are built or changed while the sketch is
+ * running, such as damaged terrain or generated enemies, to be drawn.
+ * These functions can't mirror or scale a sprite.
+ * \endparblock
+ *
+ * \par Packed sprites
+ * \parblock
+ * The `drawPacked...()` functions draw sprites stored in a compressed
+ * "packed" format. Packed arrays are created from images or ordinary sprite
+ * arrays using the `extras/tools/packsprite.py` script. The frame data is
+ * the same as for an ordinary sprite, but stored as runs of repeated bytes,
+ * literal bytes, and copies of bytes that appear earlier in the array (which
+ * lets animation frames share their common parts). It is decoded a byte at a
+ * time while drawing, so it's only a little slower than an unpacked sprite.
+ *
+ * A packed array has the following layout:
+ *
+ * - Byte 0: The width of the sprite, in pixels.
+ * - Byte 1: The height of the sprite, in pixels.
+ * - Byte 2: The number of frames.
+ * - Byte 3: Flags. If bit 0 is set, each frame has a mask as well as an
+ *   image, for use with `drawPackedPlusMask()`.
+ * - A table of 16 bit (little endian) offsets from the start of the array to
+ *   the data for each frame. If the array has masks, each frame has two
+ *   entries: one for the image data followed by one for the mask data.
+ * - The data for the frames. Each frame's data is a series of codes, which
+ *   continues until `width * ((height + 7) / 8)` bytes have been produced:
+ *   - `0x00` to `0x7F`: The following 1 to 128 (code + 1) bytes are used as
+ *     they are.
+ *   - `0x80` to `0xBF`: The following byte is repeated 2 to 65
+ *     ((code & 0x3F) + 2) times.
+ *   - `0xC0` to `0xFF`: 3 to 66 ((code & 0x3F) + 3) bytes are copied from
+ *     earlier in the array. The following 16 bit (little endian) value is the
+ *     distance back from the address of the code to the first byte to copy.
+ * \endparblock
+ *
  * \note
  * \parblock
  * A separate `SpritesB` class is available as an alternative to this class.
@@ -115,6 +170,29 @@ class Sprites
     static void drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
                                  const uint8_t *mask, uint8_t frame, uint8_t mask_frame);
 
+    /** \brief
+     * Draw a mirrored sprite using a separate image and mask array.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param mask A pointer to the array containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use (can be different
+     * from the image frame number).
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \details
+     * This works the same as the `drawExternalMask()` function without a `mirror`
+     * parameter, except that the sprite is drawn flipped. The code for
+     * drawing mirrored sprites is only included in a sketch that uses it.
+     *
+     * \see drawExternalMask()
+     */
+    static void drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
+                                 const uint8_t *mask, uint8_t frame, uint8_t mask_frame,
+                                 uint8_t mirror);
+
     /** \brief
      * Draw a sprite using an array containing both image and mask values.
      *
@@ -151,6 +229,26 @@ class Sprites
      */
     static void drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite using an array containing both image and mask
+     * values.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image/mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \details
+     * This works the same as the `drawPlusMask()` function without a `mirror`
+     * parameter, except that the sprite is drawn flipped. The code for
+     * drawing mirrored sprites is only included in a sketch that uses it.
+     *
+     * \see drawPlusMask()
+     */
+    static void drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                             uint8_t mirror);
+
     /** \brief
      * Draw a sprite by replacing the existing content completely.
      *
@@ -182,6 +280,25 @@ class Sprites
      */
     static void drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite by replacing the existing content completely.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \details
+     * This works the same as the `drawOverwrite()` function without a `mirror`
+     * parameter, except that the sprite is drawn flipped. The code for
+     * drawing mirrored sprites is only included in a sketch that uses it.
+     *
+     * \see drawOverwrite()
+     */
+    static void drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                              uint8_t mirror);
+
     /** \brief
      * "Erase" a sprite.
      *
@@ -213,6 +330,25 @@ class Sprites
      */
     static void drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * "Erase" a mirrored sprite.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to erase.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \details
+     * This works the same as the `drawErase()` function without a `mirror`
+     * parameter, except that the sprite is drawn flipped. The code for
+     * drawing mirrored sprites is only included in a sketch that uses it.
+     *
+     * \see drawErase()
+     */
+    static void drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                          uint8_t mirror);
+
     /** \brief
      * Draw a sprite using only the bits set to 1.
      *
@@ -243,6 +379,353 @@ class Sprites
      */
     static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite using only the bits set to 1.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \details
+     * This works the same as the `drawSelfMasked()` function without a `mirror`
+     * parameter, except that the sprite is drawn flipped. The code for
+     * drawing mirrored sprites is only included in a sketch that uses it.
+     *
+     * \see drawSelfMasked()
+     */
+    static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                               uint8_t mirror);
+
+    /** \brief
+     * Draw a sprite scaled up 2 or 4 times.
+     *
+     * \param x,y The coordinates of the top left pixel location of the
+     * scaled sprite.
+     * \param bitmap A pointer to the array containing the image frames (and
+     * the mask frames for `SPRITE_PLUS_MASK`).
+     * \param frame The frame number of the image to draw.
+     * \param scale The scale factor: 2 or 4. Each pixel of the sprite is
+     * drawn as a `scale` by `scale` block, so a 16x16 sprite drawn with a
+     * scale of 2 covers 32x32 pixels.
+     * \param drawMode `SPRITE_OVERWRITE` (the default), `SPRITE_PLUS_MASK`,
+     * `SPRITE_IS_MASK` or `SPRITE_IS_MASK_ERASE`. The pixels are drawn the
+     * same way as by `drawOverwrite()`, `drawPlusMask()`, `drawSelfMasked()`
+     * and `drawErase()`.
+     *
+     * \details
+     * Each byte of the sprite is expanded to 2 or 4 bytes using a small table
+     * and each expanded byte is written to `scale` columns of the screen
+     * buffer, so drawing a scaled sprite is about as fast as drawing an
+     * unscaled sprite of the scaled size. The same array can be drawn at its
+     * normal size and scaled, such as for a title screen or a zoom effect,
+     * without keeping a larger copy of it.
+     *
+     * A scale other than 2 or 4 draws the sprite at its normal size.
+     * Scaled sprites can't be mirrored.
+     *
+     * \see drawExternalMaskScaled() Arduboy2Base::drawBitmapScaled()
+     */
+    static void drawScaled(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                           uint8_t scale, uint8_t drawMode = SPRITE_OVERWRITE);
+
+    /** \brief
+     * Draw a sprite scaled up 2 or 4 times, using a separate mask array.
+     *
+     * \param x,y The coordinates of the top left pixel location of the
+     * scaled sprite.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param mask A pointer to the array containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use (can be different
+     * from the image frame number).
+     * \param scale The scale factor: 2 or 4.
+     *
+     * \details
+     * This works the same as `drawExternalMask()` except that the sprite and
+     * its mask are scaled up, as with `drawScaled()`.
+     *
+     * \see drawScaled() drawExternalMask()
+     */
+    static void drawExternalMaskScaled(int16_t x, int16_t y, const uint8_t *bitmap,
+                                       const uint8_t *mask, uint8_t frame,
+                                       uint8_t mask_frame, uint8_t scale);
+
+    /** \brief
+     * Draw a sprite from an array in RAM using a separate mask array in RAM.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array in RAM containing the image frames.
+     * \param mask A pointer to the array in RAM containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use (can be different
+     * from the image frame number).
+     *
+     * \details
+     * This works the same as `drawExternalMask()` except that both arrays are
+     * in RAM.
+     *
+     * \see drawExternalMask() SpritesT
+     */
+    static void drawExternalMaskRAM(int16_t x, int16_t y, const uint8_t *bitmap,
+                                    const uint8_t *mask, uint8_t frame, uint8_t mask_frame);
+
+    /** \brief
+     * Draw a sprite from an array in RAM using the mask bytes interleaved with
+     * the image bytes.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array in RAM containing the image and
+     * mask frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawPlusMask()` except that the array is in RAM.
+     *
+     * \see drawPlusMask() SpritesT
+     */
+    static void drawPlusMaskRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+
+    /** \brief
+     * Draw a sprite from an array in RAM by replacing the existing content
+     * completely.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array in RAM containing the image frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawOverwrite()` except that the array is in RAM.
+     *
+     * \see drawOverwrite() SpritesT
+     */
+    static void drawOverwriteRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+
+    /** \brief
+     * "Erase" a sprite from an array in RAM.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array in RAM containing the image frames.
+     * \param frame The frame number of the image to erase.
+     *
+     * \details
+     * This works the same as `drawErase()` except that the array is in RAM.
+     *
+     * \see drawErase() SpritesT
+     */
+    static void drawEraseRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+
+    /** \brief
+     * Draw a sprite from an array in RAM using only the bits set to 1.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array in RAM containing the image frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawSelfMasked()` except that the array is in
+     * RAM.
+     *
+     * \see drawSelfMasked() SpritesT
+     */
+    static void drawSelfMaskedRAM(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+
+    /** \brief
+     * Draw a packed sprite using a separate packed mask array.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the packed array containing the image frames.
+     * \param mask A pointer to the packed array containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use (can be different
+     * from the image frame number).
+     *
+     * \details
+     * This works the same as `drawExternalMask()` except that both arrays are
+     * in the packed format. The mask array must have the same width and
+     * height as the image array.
+     *
+     * \see drawExternalMask()
+     */
+    static void drawPackedExternalMask(int16_t x, int16_t y,
+                                       const uint8_t *sprite, const uint8_t *mask,
+                                       uint8_t frame, uint8_t mask_frame);
+
+    /** \brief
+     * Draw a packed sprite using the mask contained in the same array.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the packed array containing the image and
+     * mask frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawPlusMask()`. The packed array must have been
+     * created with masks (bit 0 of the flags byte is set).
+     *
+     * \see drawPlusMask()
+     */
+    static void drawPackedPlusMask(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * Draw a packed sprite by replacing the existing content completely.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the packed array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawOverwrite()`.
+     *
+     * \see drawOverwrite()
+     */
+    static void drawPackedOverwrite(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * "Erase" a packed sprite.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the packed array containing the image frames.
+     * \param frame The frame number of the image to erase.
+     *
+     * \details
+     * This works the same as `drawErase()`.
+     *
+     * \see drawErase()
+     */
+    static void drawPackedErase(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * Draw a packed sprite using only the bits set to 1.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the packed array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This works the same as `drawSelfMasked()`.
+     *
+     * \see drawSelfMasked()
+     */
+    static void drawPackedSelfMasked(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * Draw a scrolling background made of tiles, using a map in RAM.
+     *
+     * \param scrollX,scrollY The position within the map, in pixels, to be
+     * drawn at the top left corner of the screen.
+     * \param tileset A pointer to an array in program memory containing the
+     * tile images, in the same format as a sprite with a frame for each tile.
+     * The width and height must both be 8 or both be 16.
+     * \param map A pointer to an array in RAM containing the tile (frame)
+     * number for each position in the map. The tile numbers are given left to
+     * right, then top to bottom.
+     * \param mapWidth,mapHeight The width and height of the map, in tiles.
+     *
+     * \details
+     * All the tiles of the map that are on the screen are drawn, as with
+     * `drawOverwrite()`, in a single call. The map is clipped to the screen
+     * once, rather than once per tile. Areas of the screen outside the map
+     * are left unchanged.
+     *
+     * When `scrollY` is a multiple of 8, each row of a tile lines up with a
+     * row of bytes in the screen buffer and is copied straight into it.
+     * Otherwise each screen byte is made from the two tile bytes above and
+     * below it.
+     *
+     * \see drawTilemap_P() drawOverwrite()
+     */
+    static void drawTilemap(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                            const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight);
+
+    /** \brief
+     * Draw a scrolling background made of tiles, using a map in program
+     * memory.
+     *
+     * \param scrollX,scrollY The position within the map, in pixels, to be
+     * drawn at the top left corner of the screen.
+     * \param tileset A pointer to an array in program memory containing the
+     * tile images.
+     * \param map A pointer to an array in program memory containing the tile
+     * number for each position in the map.
+     * \param mapWidth,mapHeight The width and height of the map, in tiles.
+     *
+     * \details
+     * This is the same as `drawTilemap()` except that the map is located in
+     * program memory.
+     *
+     * \see drawTilemap()
+     */
+    static void drawTilemap_P(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                              const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight);
+
+    /** \brief
+     * Test if the pixels of two sprites overlap.
+     *
+     * \param x1,y1 The coordinates of the top left pixel location of the
+     * first sprite.
+     * \param bitmap1 A pointer to the array containing the first sprite's
+     * image frames.
+     * \param frame1 The frame number of the first sprite.
+     * \param x2,y2 The coordinates of the top left pixel location of the
+     * second sprite.
+     * \param bitmap2 A pointer to the array containing the second sprite's
+     * image frames.
+     * \param frame2 The frame number of the second sprite.
+     * \param mask1,mask2 Pointers to separate mask arrays for the sprites, as
+     * used with `drawExternalMask()`, or `NULL` (the default) for none.
+     * \param drawMode1,drawMode2 The format of each sprite's array:
+     * `SPRITE_PLUS_MASK` for an array drawn with `drawPlusMask()`, or
+     * `SPRITE_AUTO_MODE` (the default) for any other.
+     *
+     * \return `true` if any pixel of the first sprite's shape is at the same
+     * location as a pixel of the second sprite's shape.
+     *
+     * \details
+     * The shape of a sprite is the pixels set to 1 in its mask: the separate
+     * mask array if one is given, or the mask bytes of a `SPRITE_PLUS_MASK`
+     * array. A sprite without a mask uses the pixels set to 1 in its image.
+     * The frame number of a separate mask is the same as the sprite's frame
+     * number. The arrays are in the same format as for drawing.
+     *
+     * Only the area where the two sprites' rectangles overlap is tested. The
+     * mask bytes of the first sprite are tested a column at a time against
+     * the second sprite's mask bytes, shifted to line up with them, and the
+     * test stops at the first column where they have a pixel in common. This
+     * takes about as long as drawing the overlapping area once, so it's
+     * practical to do after `Arduboy2Base::collide()` has found that the
+     * rectangles of two sprites intersect.
+     *
+     * \code{.cpp}
+     * if (Sprites::collide(playerX, playerY, player, playerFrame,
+     *                      enemyX, enemyY, enemy, enemyFrame,
+     *                      NULL, enemyMask)) {
+     *   playerHit();
+     * }
+     * \endcode
+     *
+     * \see Arduboy2Base::collide(Rect, Rect)
+     */
+    static bool collide(int16_t x1, int16_t y1, const uint8_t *bitmap1, uint8_t frame1,
+                        int16_t x2, int16_t y2, const uint8_t *bitmap2, uint8_t frame2,
+                        const uint8_t *mask1 = NULL, const uint8_t *mask2 = NULL,
+                        uint8_t drawMode1 = SPRITE_AUTO_MODE,
+                        uint8_t drawMode2 = SPRITE_AUTO_MODE);
+
+    // Master function for tilemaps.
+    // (Not officially part of the API)
+    static void drawTiles(int16_t scrollX, int16_t scrollY, const uint8_t *tileset,
+                          const uint8_t *map, uint8_t mapWidth, uint8_t mapHeight,
+                          bool mapInProgmem);
+
+    // Master function for packed sprites.
+    // (Not officially part of the API)
+    static void drawPacked(int16_t x, int16_t y,
+                           const uint8_t *sprite, uint8_t frame,
+                           const uint8_t *mask, uint8_t mask_frame,
+                           uint8_t drawMode);
+
     // Master function. Needs to be abstracted into separate function for
     // every render type.
     // (Not officially part of the API)
@@ -255,6 +738,37 @@ class Sprites
     static void drawBitmap(int16_t x, int16_t y,
                            const uint8_t *bitmap, const uint8_t *mask,
                            uint8_t w, uint8_t h, uint8_t draw_mode);
+
+    // drawBitmap() for a sprite with its top on a page boundary.
+    // (Not officially part of the API)
+    static void drawAligned(int8_t sRow, uint16_t ofs,
+                            const uint8_t *bitmap, const uint8_t *mask,
+                            uint8_t w, uint8_t start_h, uint8_t xOffset,
+                            uint8_t loop_h, uint8_t rendered_width,
+                            uint8_t draw_mode);
+
+    // Master function for mirrored sprites. Kept apart from draw() so the
+    // mirroring code is only linked into sketches that use it.
+    // (Not officially part of the API)
+    static void drawMirrored(int16_t x, int16_t y,
+                             const uint8_t *bitmap, uint8_t frame,
+                             const uint8_t *mask, uint8_t sprite_frame,
+                             uint8_t drawMode, uint8_t mirror);
+
+    // drawBitmap() for a mirrored sprite.
+    // (Not officially part of the API)
+    static void drawBitmapMirrored(int16_t x, int16_t y,
+                                   const uint8_t *bitmap, const uint8_t *mask,
+                                   uint8_t w, uint8_t h, uint8_t draw_mode,
+                                   uint8_t mirror);
+
+    // drawBitmap() for a sprite scaled up 2 or 4 times. Also used by
+    // Arduboy2Base::drawBitmapScaled(), with SPRITE_IS_MASK_INVERT for INVERT.
+    // (Not officially part of the API)
+    static void drawBitmapScaled(int16_t x, int16_t y,
+                                 const uint8_t *bitmap, const uint8_t *mask,
+                                 uint8_t w, uint8_t h, uint8_t draw_mode,
+                                 uint8_t scale);
 };
 
 #endif
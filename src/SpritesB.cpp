@@ -34,30 +34,41 @@ void SpritesB::drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t
 }
 
 
-//common functions
-void SpritesB::draw(int16_t x, int16_t y,
-                   const uint8_t *bitmap, uint8_t frame,
-                   const uint8_t *mask, uint8_t sprite_frame,
-                   uint8_t drawMode)
+// Get the width and height of a sprite and move the image and mask
+// pointers to the start of the frames to be drawn
+static void frameStart(const uint8_t *&bitmap, uint8_t frame,
+                       const uint8_t *&mask, uint8_t mask_frame,
+                       uint8_t drawMode, uint8_t &width, uint8_t &height)
 {
   unsigned int frame_offset;
 
-  if (bitmap == NULL)
-    return;
-
-  uint8_t width = pgm_read_byte(bitmap);
-  uint8_t height = pgm_read_byte(++bitmap);
+  width = pgm_read_byte(bitmap);
+  height = pgm_read_byte(++bitmap);
   bitmap++;
-  if (frame > 0 || sprite_frame > 0) {
+  if (frame > 0 || mask_frame > 0) {
     frame_offset = (width * ( height / 8 + ( height % 8 == 0 ? 0 : 1)));
     // sprite plus mask uses twice as much space for each frame
     if (drawMode == SPRITE_PLUS_MASK) {
       frame_offset *= 2;
     } else if (mask != NULL) {
-      mask += sprite_frame * frame_offset;
+      mask += mask_frame * frame_offset;
     }
     bitmap += frame * frame_offset;
   }
+}
+
+//common functions
+void SpritesB::draw(int16_t x, int16_t y,
+                   const uint8_t *bitmap, uint8_t frame,
+                   const uint8_t *mask, uint8_t sprite_frame,
+                   uint8_t drawMode)
+{
+  uint8_t width, height;
+
+  if (bitmap == NULL)
+    return;
+
+  frameStart(bitmap, frame, mask, sprite_frame, drawMode, width, height);
 
   // if we're detecting the draw mode then base it on whether a mask
   // was passed as a separate object
@@ -73,12 +84,18 @@ void SpritesB::drawBitmap(int16_t x, int16_t y,
                          uint8_t w, uint8_t h, uint8_t draw_mode)
 {
   // no need to draw at all of we're offscreen
-  if (x + w <= 0 || x > WIDTH - 1 || y + h <= 0 || y > HEIGHT - 1)
+  if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
     return;
 
   if (bitmap == NULL)
     return;
 
+  #ifdef DIRTY_TRACKING_MODE
+  // the sprite is drawn in whole pages, so round the height up
+  Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
   // xOffset technically doesn't need to be 16 bit but the math operations
   // are measurably faster if it is
   uint16_t xOffset, ofs;
@@ -90,32 +107,36 @@ void SpritesB::drawBitmap(int16_t x, int16_t y,
     sRow--;
   }
 
+  // the first and last pages (8 pixel high rows) that can be drawn on
+  const int8_t firstPage = CLIP_TOP / 8;
+  const int8_t lastPage = (CLIP_BOTTOM - 1) / 8;
+
   // if the left side of the render is offscreen skip those loops
-  if (x < 0) {
-    xOffset = abs(x);
+  if (x < CLIP_LEFT) {
+    xOffset = CLIP_LEFT - x;
   } else {
     xOffset = 0;
   }
 
   // if the right side of the render is offscreen skip those loops
-  if (x + w > WIDTH - 1) {
-    rendered_width = ((WIDTH - x) - xOffset);
+  if (x + w > CLIP_RIGHT - 1) {
+    rendered_width = ((CLIP_RIGHT - x) - xOffset);
   } else {
     rendered_width = (w - xOffset);
   }
 
   // if the top side of the render is offscreen skip those loops
-  if (sRow < -1) {
-    start_h = abs(sRow) - 1;
+  if (sRow < firstPage - 1) {
+    start_h = firstPage - 1 - sRow;
   } else {
     start_h = 0;
   }
 
   loop_h = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
 
-  // if (sRow + loop_h - 1 > (HEIGHT/8)-1)
-  if (sRow + loop_h > (HEIGHT / 8)) {
-    loop_h = (HEIGHT / 8) - sRow;
+  // if (sRow + loop_h - 1 > lastPage)
+  if (sRow + loop_h > lastPage + 1) {
+    loop_h = lastPage + 1 - sRow;
   }
 
   // prepare variables for loops later so we can compare with 0
@@ -138,6 +159,12 @@ void SpritesB::drawBitmap(int16_t x, int16_t y,
   mask_ofs += initial_bofs + ofs_step - 1;
 
   for (uint8_t a = 0; a < loop_h; a++) {
+    #ifdef CLIP_RECT_MODE
+    // the rows of the two pages inside the clip rectangle
+    uint16_t clip = Arduboy2Base::clipPageMask(sRow) |
+                    (Arduboy2Base::clipPageMask(sRow + 1) << 8);
+    #endif
+
     for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
       uint8_t data;
 
@@ -152,13 +179,18 @@ void SpritesB::drawBitmap(int16_t x, int16_t y,
         mask_data = ~(pgm_read_byte(mask_ofs) * mul_amt);
       }
 
-      if (sRow >= 0) {
+      #ifdef CLIP_RECT_MODE
+      bitmap_data &= clip;
+      mask_data |= ~clip;
+      #endif
+
+      if (sRow >= firstPage) {
         data = Arduboy2Base::sBuffer[ofs];
         data &= (uint8_t)(mask_data);
         data |= (uint8_t)(bitmap_data);
         Arduboy2Base::sBuffer[ofs] = data;
       }
-      if (yOffset != 0 && sRow < 7) {
+      if (yOffset != 0 && sRow < lastPage) {
         data = Arduboy2Base::sBuffer[ofs + WIDTH];
         data &= (*((unsigned char *) (&mask_data) + 1));
         data |= (*((unsigned char *) (&bitmap_data) + 1));
@@ -174,3 +206,225 @@ void SpritesB::drawBitmap(int16_t x, int16_t y,
     ofs += WIDTH - rendered_width;
   }
 }
+
+// The mirrored versions are kept apart, so the mirroring code is only linked
+// into sketches that use it
+
+void SpritesB::drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
+                               const uint8_t *mask, uint8_t frame, uint8_t mask_frame,
+                               uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, mask, mask_frame, SPRITE_MASKED, mirror);
+}
+
+void SpritesB::drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                             uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_OVERWRITE, mirror);
+}
+
+void SpritesB::drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                         uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_IS_MASK_ERASE, mirror);
+}
+
+void SpritesB::drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                              uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_IS_MASK, mirror);
+}
+
+void SpritesB::drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                            uint8_t mirror)
+{
+  drawMirrored(x, y, bitmap, frame, NULL, 0, SPRITE_PLUS_MASK, mirror);
+}
+
+void SpritesB::drawMirrored(int16_t x, int16_t y,
+                            const uint8_t *bitmap, uint8_t frame,
+                            const uint8_t *mask, uint8_t sprite_frame,
+                            uint8_t drawMode, uint8_t mirror)
+{
+  uint8_t width, height;
+
+  if (bitmap == NULL)
+    return;
+
+  frameStart(bitmap, frame, mask, sprite_frame, drawMode, width, height);
+
+  drawBitmapMirrored(x, y, bitmap, mask, width, height, drawMode, mirror);
+}
+
+// the bits of each nibble value in reverse order, for vertical mirroring
+static const uint8_t reversedNibbles[16] PROGMEM = {
+  0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+  0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
+static uint8_t reverseBits(uint8_t b)
+{
+  return (pgm_read_byte(reversedNibbles + (b & 0x0F)) << 4) |
+         pgm_read_byte(reversedNibbles + (b >> 4));
+}
+
+void SpritesB::drawBitmapMirrored(int16_t x, int16_t y,
+                                  const uint8_t *bitmap, const uint8_t *mask,
+                                  uint8_t w, uint8_t h, uint8_t draw_mode,
+                                  uint8_t mirror)
+{
+  // no need to draw at all of we're offscreen
+  if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+      y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
+    return;
+
+  if (bitmap == NULL)
+    return;
+
+  // A vertical flip reverses whole pages, so the sprite is drawn higher by
+  // the unused rows at the bottom of its last page, as for Sprites
+  if (mirror & MIRROR_VERTICAL) {
+    y -= ((h + 7) & ~7) - h;
+  }
+
+  #ifdef DIRTY_TRACKING_MODE
+  // the sprite is drawn in whole pages, so round the height up
+  Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+  #endif
+
+  // xOffset technically doesn't need to be 16 bit but the math operations
+  // are measurably faster if it is
+  uint16_t xOffset, ofs;
+  int8_t yOffset = y & 7;
+  int8_t sRow = y / 8;
+  uint8_t loop_h, start_h, rendered_width;
+
+  if (y < 0 && yOffset > 0) {
+    sRow--;
+  }
+
+  // the first and last pages (8 pixel high rows) that can be drawn on
+  const int8_t firstPage = CLIP_TOP / 8;
+  const int8_t lastPage = (CLIP_BOTTOM - 1) / 8;
+
+  // if the left side of the render is offscreen skip those loops
+  if (x < CLIP_LEFT) {
+    xOffset = CLIP_LEFT - x;
+  } else {
+    xOffset = 0;
+  }
+
+  // if the right side of the render is offscreen skip those loops
+  if (x + w > CLIP_RIGHT - 1) {
+    rendered_width = ((CLIP_RIGHT - x) - xOffset);
+  } else {
+    rendered_width = (w - xOffset);
+  }
+
+  // if the top side of the render is offscreen skip those loops
+  if (sRow < firstPage - 1) {
+    start_h = firstPage - 1 - sRow;
+  } else {
+    start_h = 0;
+  }
+
+  const uint8_t pages = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
+  loop_h = pages;
+
+  // if (sRow + loop_h - 1 > lastPage)
+  if (sRow + loop_h > lastPage + 1) {
+    loop_h = lastPage + 1 - sRow;
+  }
+
+  // prepare variables for loops later so we can compare with 0
+  // instead of comparing two variables
+  loop_h -= start_h;
+
+  sRow += start_h;
+  ofs = (sRow * WIDTH) + x + xOffset;
+
+  uint8_t mul_amt = 1 << yOffset;
+  uint16_t mask_data;
+  uint16_t bitmap_data;
+
+  const uint8_t ofs_step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+
+  // A mirrored sprite is drawn from the other end of its rows or columns,
+  // stepping backwards through the data
+  uint8_t src_col = xOffset;
+  uint8_t src_row = start_h;
+  int8_t col_step = ofs_step;
+  int16_t row_step = w * ofs_step;
+
+  if (mirror & MIRROR_HORIZONTAL) {
+    src_col = w - 1 - xOffset;
+    col_step = -col_step;
+  }
+  if (mirror & MIRROR_VERTICAL) {
+    src_row = pages - 1 - start_h;
+    row_step = -row_step;
+  }
+
+  const int16_t ofs_stride = row_step - (rendered_width * col_step);
+  const uint16_t initial_bofs = ((src_row * w) + src_col)*ofs_step;
+
+  const uint8_t *bofs = bitmap + initial_bofs;
+  const uint8_t *mask_ofs = !mask ? bitmap : mask;
+  mask_ofs += initial_bofs + ofs_step - 1;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    #ifdef CLIP_RECT_MODE
+    // the rows of the two pages inside the clip rectangle
+    uint16_t clip = Arduboy2Base::clipPageMask(sRow) |
+                    (Arduboy2Base::clipPageMask(sRow + 1) << 8);
+    #endif
+
+    for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
+      uint8_t data;
+
+      uint8_t image = pgm_read_byte(bofs);
+      uint8_t mask_byte = pgm_read_byte(mask_ofs);
+
+      if (mirror & MIRROR_VERTICAL) {
+        image = reverseBits(image);
+        mask_byte = reverseBits(mask_byte);
+      }
+
+      bitmap_data = image * mul_amt;
+      mask_data = ~bitmap_data;
+
+      if (draw_mode == SPRITE_UNMASKED) {
+        mask_data = ~(0xFF * mul_amt);
+      } else if (draw_mode == SPRITE_IS_MASK_ERASE) {
+        bitmap_data = 0;
+      } else {
+        mask_data = ~(mask_byte * mul_amt);
+      }
+
+      #ifdef CLIP_RECT_MODE
+      bitmap_data &= clip;
+      mask_data |= ~clip;
+      #endif
+
+      if (sRow >= firstPage) {
+        data = Arduboy2Base::sBuffer[ofs];
+        data &= (uint8_t)(mask_data);
+        data |= (uint8_t)(bitmap_data);
+        Arduboy2Base::sBuffer[ofs] = data;
+      }
+      if (yOffset != 0 && sRow < lastPage) {
+        data = Arduboy2Base::sBuffer[ofs + WIDTH];
+        data &= (*((unsigned char *) (&mask_data) + 1));
+        data |= (*((unsigned char *) (&bitmap_data) + 1));
+        Arduboy2Base::sBuffer[ofs + WIDTH] = data;
+      }
+      ofs++;
+      mask_ofs += col_step;
+      bofs += col_step;
+    }
+    sRow++;
+    bofs += ofs_stride;
+    mask_ofs += ofs_stride;
+    ofs += WIDTH - rendered_width;
+  }
+}
@@ -55,6 +55,24 @@ class SpritesB
     static void drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
                                  const uint8_t *mask, uint8_t frame, uint8_t mask_frame);
 
+    /** \brief
+     * Draw a mirrored sprite using a separate image and mask array.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param mask A pointer to the array containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use (can be different
+     * from the image frame number).
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \see Sprites::drawExternalMask()
+     */
+    static void drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
+                                 const uint8_t *mask, uint8_t frame, uint8_t mask_frame,
+                                 uint8_t mirror);
+
     /** \brief
      * Draw a sprite using an array containing both image and mask values.
      *
@@ -66,6 +84,21 @@ class SpritesB
      */
     static void drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite using an array containing both image and mask
+     * values.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image/mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \see Sprites::drawPlusMask()
+     */
+    static void drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                             uint8_t mirror);
+
     /** \brief
      * Draw a sprite by replacing the existing content completely.
      *
@@ -77,6 +110,20 @@ class SpritesB
      */
     static void drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite by replacing the existing content completely.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \see Sprites::drawOverwrite()
+     */
+    static void drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                              uint8_t mirror);
+
     /** \brief
      * "Erase" a sprite.
      *
@@ -88,6 +135,20 @@ class SpritesB
      */
     static void drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * "Erase" a mirrored sprite.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to erase.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \see Sprites::drawErase()
+     */
+    static void drawErase(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                          uint8_t mirror);
+
     /** \brief
      * Draw a sprite using only the bits set to 1.
      *
@@ -99,6 +160,20 @@ class SpritesB
      */
     static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Draw a mirrored sprite using only the bits set to 1.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param frame The frame number of the image to draw.
+     * \param mirror `MIRROR_HORIZONTAL` and/or `MIRROR_VERTICAL`, for the
+     * directions to flip the sprite in.
+     *
+     * \see Sprites::drawSelfMasked()
+     */
+    static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame,
+                               uint8_t mirror);
+
     // Master function. Needs to be abstracted into separate function for
     // every render type.
     // (Not officially part of the API)
@@ -111,6 +186,21 @@ class SpritesB
     static void drawBitmap(int16_t x, int16_t y,
                            const uint8_t *bitmap, const uint8_t *mask,
                            uint8_t w, uint8_t h, uint8_t draw_mode);
+
+    // Master function for mirrored sprites. Kept apart from draw() so the
+    // mirroring code is only linked into sketches that use it.
+    // (Not officially part of the API)
+    static void drawMirrored(int16_t x, int16_t y,
+                             const uint8_t *bitmap, uint8_t frame,
+                             const uint8_t *mask, uint8_t sprite_frame,
+                             uint8_t drawMode, uint8_t mirror);
+
+    // drawBitmap() for a mirrored sprite.
+    // (Not officially part of the API)
+    static void drawBitmapMirrored(int16_t x, int16_t y,
+                                   const uint8_t *bitmap, const uint8_t *mask,
+                                   uint8_t w, uint8_t h, uint8_t draw_mode,
+                                   uint8_t mirror);
 };
 
 #endif
@@ -13,6 +13,10 @@
 #define SPRITE_PLUS_MASK 3
 #define SPRITE_IS_MASK 250
 #define SPRITE_IS_MASK_ERASE 251
+#define SPRITE_IS_MASK_INVERT 252 // (Not officially part of the API)
 #define SPRITE_AUTO_MODE 255
 
+#define MIRROR_HORIZONTAL 0x01 /**< Draw a sprite flipped left to right. */
+#define MIRROR_VERTICAL 0x02   /**< Draw a sprite flipped top to bottom. */
+
 #endif
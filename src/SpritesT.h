@@ -0,0 +1,314 @@
+/**
+ * @file SpritesT.h
+ * \brief
+ * A class template for drawing animated sprites with a draw mode, and
+ * optionally a sprite size, chosen at compile time.
+ */
+
+#ifndef SpritesT_h
+#define SpritesT_h
+
+#include "Arduboy2.h"
+#include "SpritesCommon.h"
+
+/** \brief
+ * A class template for drawing animated sprites with a draw mode, and
+ * optionally a sprite size, chosen at compile time.
+ *
+ * \tparam drawMode The draw mode. One of `SPRITE_OVERWRITE`,
+ * `SPRITE_IS_MASK`, `SPRITE_IS_MASK_ERASE`, `SPRITE_PLUS_MASK` or
+ * `SPRITE_MASKED`.
+ * \tparam spriteWidth,spriteHeight The width and height of every sprite
+ * drawn with the class, in pixels, or 0 (the default) to read them from each
+ * sprite array. Either both or neither must be given.
+ * \tparam inProgmem `true` (the default) if the sprite arrays are in program
+ * memory, or `false` if they're in RAM.
+ *
+ * \details
+ * The sprite arrays are in the same format as for the `Sprites` class and
+ * the functions draw the same pixels as the `Sprites` functions for the
+ * same draw mode:
+ *
+ * Draw mode              | Sprites function
+ * ---------------------- | ------------------------------
+ * `SPRITE_OVERWRITE`     | `Sprites::drawOverwrite()`
+ * `SPRITE_IS_MASK`       | `Sprites::drawSelfMasked()`
+ * `SPRITE_IS_MASK_ERASE` | `Sprites::drawErase()`
+ * `SPRITE_PLUS_MASK`     | `Sprites::drawPlusMask()`
+ * `SPRITE_MASKED`        | `Sprites::drawExternalMask()`
+ *
+ * Because the draw mode is a template parameter, only the drawing loop for
+ * that mode is compiled, and none of the mode tests are done while drawing.
+ * This usually produces less code than `Sprites` or `SpritesB` when a
+ * sketch only uses one or two draw modes, and each sprite is drawn faster.
+ *
+ * If all the sprites drawn with a class have the same size, such as the
+ * tiles of a game, giving it as `spriteWidth` and `spriteHeight` lets the
+ * frame offsets and loop counts be calculated when the sketch is compiled.
+ * The size is still included at the start of each sprite array, but isn't
+ * read.
+ *
+ * Sprite arrays in RAM, such as sprites that are built or changed while
+ * the sketch is running, can be drawn by giving `false` for `inProgmem`.
+ * The same drawing loops are used, reading the arrays with ordinary loads,
+ * which are a little faster than reading from program memory.
+ *
+ * The `SpritesT.h` header file must be included to use this class:
+ *
+ * \code{.cpp}
+ * #include <Arduboy2.h>
+ * #include <SpritesT.h>
+ *
+ * // Any sprite in SPRITE_PLUS_MASK format
+ * typedef SpritesT<SPRITE_PLUS_MASK> PlusMaskSprites;
+ *
+ * // 8x8 tiles in SPRITE_OVERWRITE format
+ * typedef SpritesT<SPRITE_OVERWRITE, 8, 8> TileSprites;
+ *
+ * // Any sprite in SPRITE_IS_MASK format, in RAM
+ * typedef SpritesT<SPRITE_IS_MASK, 0, 0, false> RAMSprites;
+ *
+ * PlusMaskSprites::draw(x, y, player, frame);
+ * TileSprites::draw(col * 8, row * 8, tiles, tile);
+ * RAMSprites::draw(x, y, debris, 0);
+ * \endcode
+ *
+ * \see Sprites SpritesB
+ */
+template<uint8_t drawMode, uint8_t spriteWidth = 0, uint8_t spriteHeight = 0,
+         bool inProgmem = true>
+class SpritesT
+{
+  static_assert(drawMode == SPRITE_OVERWRITE || drawMode == SPRITE_MASKED ||
+                drawMode == SPRITE_PLUS_MASK || drawMode == SPRITE_IS_MASK ||
+                drawMode == SPRITE_IS_MASK_ERASE,
+                "SpritesT: unknown draw mode");
+  static_assert((spriteWidth == 0) == (spriteHeight == 0),
+                "SpritesT: give both the sprite width and height, or neither");
+
+  public:
+    /** \brief
+     * Draw a sprite.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames (and
+     * the mask frames for `SPRITE_PLUS_MASK`).
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * This function can be used with any draw mode except `SPRITE_MASKED`,
+     * which uses `drawExternalMask()`.
+     */
+    static void draw(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+    {
+      static_assert(drawMode != SPRITE_MASKED,
+                    "SpritesT: use drawExternalMask() for SPRITE_MASKED");
+
+      uint8_t w = width(bitmap);
+      uint8_t h = height(bitmap);
+
+      drawBitmap(x, y, bitmap + 2 + (frame * frameSize(w, h)), NULL, w, h);
+    }
+
+    /** \brief
+     * Draw a sprite using a separate image and mask array.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param mask A pointer to the array containing the mask frames.
+     * \param frame The frame number of the image to draw.
+     * \param mask_frame The frame number for the mask to use.
+     *
+     * \details
+     * This function can only be used with the `SPRITE_MASKED` draw mode.
+     *
+     * \see Sprites::drawExternalMask()
+     */
+    static void drawExternalMask(int16_t x, int16_t y, const uint8_t *bitmap,
+                                 const uint8_t *mask, uint8_t frame, uint8_t mask_frame)
+    {
+      static_assert(drawMode == SPRITE_MASKED,
+                    "SpritesT: drawExternalMask() needs SPRITE_MASKED");
+
+      uint8_t w = width(bitmap);
+      uint8_t h = height(bitmap);
+      uint16_t frame_size = frameSize(w, h);
+
+      drawBitmap(x, y, bitmap + 2 + (frame * frame_size),
+                 mask + (mask_frame * frame_size), w, h);
+    }
+
+    // Draw one frame, given the start of its data.
+    // (Not officially part of the API)
+    static void drawBitmap(int16_t x, int16_t y,
+                           const uint8_t *bitmap, const uint8_t *mask,
+                           uint8_t w, uint8_t h)
+    {
+      if (spriteWidth != 0) {
+        w = spriteWidth;
+        h = spriteHeight;
+      }
+
+      // no need to draw at all if we're offscreen
+      if (x + w <= CLIP_LEFT || x > CLIP_RIGHT - 1 ||
+          y + h <= CLIP_TOP || y > CLIP_BOTTOM - 1)
+        return;
+
+      #ifdef DIRTY_TRACKING_MODE
+      // the sprite is drawn in whole pages, so round the height up
+      Arduboy2Base::markDirty(x, y, w, (h + 7) & ~7);
+      #endif
+
+      const uint8_t yOffset = y & 7;
+      int8_t sRow = y / 8;
+
+      if (y < 0 && yOffset > 0) {
+        sRow--;
+      }
+
+      // the first and last pages (8 pixel high rows) that can be drawn on
+      const int8_t firstPage = CLIP_TOP / 8;
+      const int8_t lastPage = (CLIP_BOTTOM - 1) / 8;
+
+      // skip the columns off the left and right sides
+      uint8_t xOffset = (x < CLIP_LEFT) ? CLIP_LEFT - x : 0;
+      uint8_t rendered_width = ((x + w > CLIP_RIGHT) ? CLIP_RIGHT - x : w) - xOffset;
+
+      // Skip the pages of the sprite above the first page of the screen
+      // that can be drawn on. A shifted sprite page also draws on the next
+      // screen page, so the one just above it is kept.
+      int8_t start_h = firstPage - sRow - (yOffset != 0);
+      if (start_h < 0) {
+        start_h = 0;
+      }
+
+      int8_t loop_h = (h + 7) / 8;
+      if (sRow + loop_h > lastPage + 1) {
+        loop_h = lastPage + 1 - sRow;
+      }
+      loop_h -= start_h;
+      sRow += start_h;
+
+      const uint8_t *bofs = bitmap + ((start_h * w) + xOffset) * ofs_step;
+      const uint8_t *mask_ofs = mask + (start_h * w) + xOffset;
+      uint8_t *buf = Arduboy2Base::sBuffer + (sRow * WIDTH) + x + xOffset;
+
+      const uint16_t bofs_jump = (w - rendered_width) * ofs_step;
+      const uint8_t mask_jump = w - rendered_width;
+      const uint8_t buffer_jump = WIDTH - rendered_width;
+
+      if (yOffset == 0) {
+        // a sprite on a page boundary is drawn a byte at a time
+        for (; loop_h > 0; loop_h--) {
+          uint8_t clip = 0xFF;
+          #ifdef CLIP_RECT_MODE
+          clip = Arduboy2Base::clipPageMask(sRow);
+          #endif
+
+          for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+            uint8_t image = read(bofs);
+            uint8_t mask_byte = maskByte(bofs, mask_ofs, image);
+
+            write(buf, image & clip, mask_byte & clip);
+            bofs += ofs_step;
+            mask_ofs++;
+            buf++;
+          }
+          sRow++;
+          bofs += bofs_jump;
+          mask_ofs += mask_jump;
+          buf += buffer_jump;
+        }
+        return;
+      }
+
+      const uint8_t mul_amt = 1 << yOffset;
+
+      for (; loop_h > 0; loop_h--) {
+        uint16_t clip = 0xFFFF;
+        #ifdef CLIP_RECT_MODE
+        clip = Arduboy2Base::clipPageMask(sRow) |
+               (Arduboy2Base::clipPageMask(sRow + 1) << 8);
+        #endif
+        const bool top = sRow >= firstPage;
+        const bool bottom = sRow < lastPage;
+
+        for (uint8_t iCol = rendered_width; iCol != 0; iCol--) {
+          uint8_t image = read(bofs);
+          uint16_t image_data = (image * mul_amt) & clip;
+          uint16_t mask_data = (maskByte(bofs, mask_ofs, image) * mul_amt) & clip;
+
+          if (top) {
+            write(buf, image_data, mask_data);
+          }
+          if (bottom) {
+            write(buf + WIDTH, image_data >> 8, mask_data >> 8);
+          }
+          bofs += ofs_step;
+          mask_ofs++;
+          buf++;
+        }
+        sRow++;
+        bofs += bofs_jump;
+        mask_ofs += mask_jump;
+        buf += buffer_jump;
+      }
+    }
+
+  private:
+    // bytes per column of a frame: image and mask for SPRITE_PLUS_MASK
+    static const uint8_t ofs_step = (drawMode == SPRITE_PLUS_MASK) ? 2 : 1;
+
+    static uint8_t width(const uint8_t *bitmap)
+    {
+      return spriteWidth != 0 ? spriteWidth : read(bitmap);
+    }
+
+    static uint8_t height(const uint8_t *bitmap)
+    {
+      return spriteHeight != 0 ? spriteHeight : read(bitmap + 1);
+    }
+
+    // read a byte of a sprite array
+    static uint8_t read(const uint8_t *p)
+    {
+      return inProgmem ? pgm_read_byte(p) : *p;
+    }
+
+    // the size of a frame's data
+    static uint16_t frameSize(uint8_t w, uint8_t h)
+    {
+      return (w * ((h + 7) / 8)) * ofs_step;
+    }
+
+    // the mask byte for an image byte: the pixels that the sprite changes
+    static uint8_t maskByte(const uint8_t *bofs, const uint8_t *mask_ofs, uint8_t image)
+    {
+      if (drawMode == SPRITE_OVERWRITE) {
+        return 0xFF;
+      }
+      if (drawMode == SPRITE_MASKED) {
+        return read(mask_ofs);
+      }
+      if (drawMode == SPRITE_PLUS_MASK) {
+        return read(bofs + 1);
+      }
+      return image;
+    }
+
+    // write the image and mask bytes for a column of one page
+    static void write(uint8_t *buf, uint8_t image, uint8_t mask)
+    {
+      if (drawMode == SPRITE_IS_MASK) {
+        *buf |= image;
+      }
+      else if (drawMode == SPRITE_IS_MASK_ERASE) {
+        *buf &= ~image;
+      }
+      else {
+        *buf = (*buf & ~mask) | image;
+      }
+    }
+};
+
+#endif